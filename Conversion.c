@@ -0,0 +1,31 @@
+/**
+ * \file Conversion.c
+ * \author Zevio.S et Benharchache.S
+ * \brief Fichier source des conversions entre liste et tas
+ * \date 18 decembre 2014
+ */
+
+#include "Conversion.h"
+#include "Instrumentation.h"
+
+Heap Tas_depuisListe(struct LinkedList* l, Tas_comparateur cmp){
+	ll_compact(l); // on parcourt les noeuds nous-memes
+	Heap h = Tas_creer(ll_size(l));
+	size_t i = 0;
+
+	for(struct Node* ite = l->first; ite; ite = ite->next)
+		h->heap[i++] = ite->value;
+	INSTR_COMPTER(INSTR_LISTE, pas_parcours, i);
+
+	ll_release(l);
+	Tas_fixer_comparateur(h, cmp);
+	Tas_tasser(h);
+	return h;
+}
+
+struct LinkedList* Tas_versListe(const Heap h){
+	struct LinkedList* l = ll_create();
+	Tas_compacter(h); // le contenu visible ne change pas
+	ll_insert_range(l, 0, h->heap, Tas_taille(h));
+	return l;
+}
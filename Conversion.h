@@ -0,0 +1,46 @@
+/**
+ * \file Conversion.h
+ * \author Zevio.S et Benharchache.S
+ * \brief Passage direct d'une liste chainee a un tas et inversement
+ * \date 18 decembre 2014
+ */
+
+#ifndef SOFIEN_STELLA__CONVERSION_H__
+#define SOFIEN_STELLA__CONVERSION_H__
+
+#include "Heap.h"
+#include "autres/LinkedList.h"
+
+
+/**
+ * \fn Heap Tas_depuisListe(struct LinkedList* l, Tas_comparateur cmp)
+ * \brief Deplace toutes les valeurs d'une liste dans un nouveau tas.
+ *
+ * Le tableau est alloue une seule fois a la bonne taille, rempli en un
+ * parcours de la liste puis reorganise en O(n) par Tas_tasser. Les noeuds
+ * de la liste sont liberes d'un coup, sans liberer les valeurs : la liste
+ * est videe et les valeurs appartiennent desormais a l'appelant.
+ *
+ * \param l La liste a vider.
+ * \param cmp L'ordre du tas (peut etre NULL).
+ * \return Le nouveau tas.
+ */
+Heap Tas_depuisListe(struct LinkedList* l, Tas_comparateur cmp);
+
+
+/**
+ * \fn struct LinkedList* Tas_versListe(const Heap h)
+ * \brief Cree une liste qui contient les valeurs du tas, dans l'ordre du tableau.
+ *
+ * Tous les noeuds sont alloues en un seul bloc et chaines en un seul passage
+ * (ll_insert_range). Le tas n'est pas modifie ; comme la liste libere ses
+ * valeurs, elles doivent avoir ete allouees par malloc et ne plus etre
+ * utilisees par le tas ensuite.
+ *
+ * \param h Le tas a copier.
+ * \return La nouvelle liste.
+ */
+struct LinkedList* Tas_versListe(const Heap h);
+
+
+#endif
@@ -5,60 +5,480 @@
  * \date 18 decembre 2014
  */
 
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS, MAP_NORESERVE, MADV_HUGEPAGE
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "Heap.h"
+#include "Instrumentation.h"
+#include "Recyclage.h"
+#include "Trace.h"
+
+// Chemins AVX2 des recherches de mots (compiles a part, choisis a l'execution)
+#if defined(__GNUC__) && defined(__x86_64__)
+#define TAS_AVX2
+#include <immintrin.h>
+#endif
+
+#define TAS_MAGIQUE "BIBLTAS"
+#define TAS_VERSION 1
+
+// Le mode grand engage sa reservation par pages geantes de 2 Mio
+#define TAS_PAGE_GEANTE (2*1024*1024)
+
+#define TAS_FLUX_MAGIQUE "BSDT"
+#define TAS_FLUX_VERSION 1
+
+/*
+ * En-tete du format binaire de Tas_ecrire / Tas_lire.
+ */
+struct tas_flux_entete{
+	char magique[4];
+	uint16_t version;
+	uint16_t drapeaux;	// reserve, toujours 0 pour le tas
+	uint32_t taille_enreg;
+	uint32_t reserve;
+	uint64_t nb;
+};
+
+// Taille du fichier necessaire pour contenir capacite enregistrements
+static size_t Tas_taille_projection(size_t capacite){
+	return sizeof(struct tas_entete) + capacite*sizeof(void*);
+}
+
+// Recopie size et capacite dans l'en-tete du fichier en mode persistant.
+// On l'appelle toujours apres avoir ecrit les cases : un crash entre les deux
+// laisse un en-tete qui decrit des cases deja valides.
+static void Tas_publier(Heap h){
+	if(h->entete != NULL){
+		h->entete->capacite = h->capacite;
+		h->entete->size = h->size;
+	}
+}
+
+// Projette le fichier de h (deja a la bonne taille) pour capacite enregistrements
+static int Tas_projeter(Heap h, size_t capacite){
+	void* base = mmap(NULL, Tas_taille_projection(capacite), PROT_READ | PROT_WRITE, MAP_SHARED, h->fd, 0);
+	if(base == MAP_FAILED)
+		return -1;
+	h->entete = base;
+	h->heap = (void**)((char*)base + sizeof(struct tas_entete));
+	h->capacite = capacite;
+	return 0;
+}
+
+// Met le tableau des marques de suppression a la capacite du tas.
+// Il n'existe qu'a partir du premier marquage.
+static void Tas_reserver_morts(Heap h){
+	if(h->morts == NULL)
+		return;
+	unsigned char* tmp = realloc(h->morts, h->capacite);
+	if(tmp == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir du tas");
+		exit(1);
+	}
+	h->morts = tmp;
+}
+
+// Alloue le tableau de h->capacite cases. Un petit tas utilise le tampon
+// de la structure, sans appel a malloc.
+static void** Tas_allouer_cases(Heap h){
+	if(h->capacite <= TAS_PETIT){
+		h->capacite = TAS_PETIT;
+		return h->petit;
+	}
+	INSTR_COMPTER(INSTR_TAS, allocations, 1);
+	return Recyclage_prendre(h->capacite*sizeof(void*));
+}
+
+// Nombre de cases de n cases arrondi a un multiple de pages geantes
+static size_t Tas_arrondir_geante(size_t n){
+	size_t par_page = TAS_PAGE_GEANTE / sizeof(void*);
+	return (n + par_page - 1) / par_page * par_page;
+}
+
+// Mode grand : reserve l'espace d'adresses de reserve cases (deja arrondi
+// par Tas_arrondir_geante) sans memoire derriere, aligne sur une page geante
+// pour que le noyau puisse y placer des pages de 2 Mio.
+static void** Tas_reserver_espace(size_t reserve){
+	size_t octets = reserve*sizeof(void*);
+	char* base = mmap(NULL, octets + TAS_PAGE_GEANTE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if(base == MAP_FAILED)
+		return NULL;
+	size_t avant = (TAS_PAGE_GEANTE - (uintptr_t)base % TAS_PAGE_GEANTE) % TAS_PAGE_GEANTE;
+	if(avant > 0)
+		munmap(base, avant);
+	munmap(base + avant + octets, TAS_PAGE_GEANTE - avant);
+#ifdef MADV_HUGEPAGE
+	madvise(base + avant, octets, MADV_HUGEPAGE); // un conseil : sans THP, on garde des pages de 4 Kio
+#endif
+	return (void**)(base + avant);
+}
+
+// Mode grand : rend accessibles les cases jusqu'a capacite, par pages
+// geantes entieres. Le tableau ne bouge que si la reservation est depassee.
+static void Tas_engager(Heap h, size_t capacite){
+	void** tableau = h->heap;
+	size_t reserve = h->reserve;
+	if(capacite > reserve){
+		// Reservation depassee : on en prend une deux fois plus grande
+		reserve = Tas_arrondir_geante(capacite > 2*reserve ? capacite : 2*reserve);
+		if((tableau = Tas_reserver_espace(reserve)) == NULL){
+			fprintf(stderr, "errueut lors de l'allocation de memoir du tas");
+			exit(1);
+		}
+	}
+	capacite = Tas_arrondir_geante(capacite);
+	if(capacite > reserve)
+		capacite = reserve;
+	if(mprotect(tableau, capacite*sizeof(void*), PROT_READ | PROT_WRITE) != 0){
+		fprintf(stderr, "errueut lors de l'allocation de memoir du tas");
+		exit(1);
+	}
+	if(tableau != h->heap){
+		INSTR_COMPTER(INSTR_TAS, octets_deplaces, h->size * sizeof(void*));
+		memcpy(tableau, h->heap, h->size * sizeof(void*));
+		munmap(h->heap, h->reserve*sizeof(void*));
+		h->heap = tableau;
+		h->reserve = reserve;
+	}
+	h->capacite = capacite;
+}
+
+// Agrandit le tableau pour qu'il contienne au moins capacite cases.
+// En mode persistant on agrandit le fichier puis on le reprojette.
+static void Tas_reserver(Heap h, size_t capacite){
+	if(capacite <= h->capacite)
+		return;
+	if(h->reserve > 0){
+		INSTR_COMPTER(INSTR_TAS, reallocations, 1);
+		Tas_engager(h, capacite);
+		Tas_reserver_morts(h);
+		return;
+	}
+	if(h->fd >= 0){
+		Tas_publier(h);
+		munmap(h->entete, Tas_taille_projection(h->capacite));
+		if(ftruncate(h->fd, Tas_taille_projection(capacite)) != 0 || Tas_projeter(h, capacite) != 0){
+			fprintf(stderr, "erreur lors de l'agrandissement du tas persistant");
+			exit(1);
+		}
+		INSTR_COMPTER(INSTR_TAS, reallocations, 1);
+		Tas_publier(h);
+		Tas_reserver_morts(h);
+		return;
+	}
+	INSTR_COMPTER(INSTR_TAS, reallocations, 1);
+	INSTR_COMPTER(INSTR_TAS, octets_deplaces, h->size * sizeof(void*));
+	// Le petit tampon de la structure ne peut pas etre realloue, et un
+	// tableau du cache y retourne : seuls les grands tableaux passent par realloc
+	int grand = h->heap != h->petit && h->capacite * sizeof(void*) > RECYCLAGE_MAX;
+	void** tmp = grand ? realloc(h->heap, capacite * sizeof(void*)) : Recyclage_prendre(capacite * sizeof(void*));
+	if(tmp == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir du tas");
+		exit(1);
+	}
+	if(!grand){
+		memcpy(tmp, h->heap, h->size * sizeof(void*));
+		if(h->heap != h->petit)
+			Recyclage_rendre(h->heap, h->capacite * sizeof(void*));
+	}
+	h->heap = tmp;
+	h->capacite = capacite;
+	Tas_reserver_morts(h);
+}
+
+// Echange deux cases (et leurs marques de suppression)
+static void Tas_echanger(Heap h, size_t a, size_t b){
+	void* val = h->heap[a];
+	h->heap[a] = h->heap[b];
+	h->heap[b] = val;
+	if(h->morts){
+		unsigned char mort = h->morts[a];
+		h->morts[a] = h->morts[b];
+		h->morts[b] = mort;
+	}
+}
+
+// Mode min-max : 1 si la case i est sur un niveau max (niveaux impairs), 0 sinon
+static int Tas_niveau_max(size_t i){
+	int niveau = 0;
+	for(i++; i > 1; i >>= 1)
+		niveau++;
+	return niveau & 1;
+}
+
+// Mode min-max : 1 si la case a doit etre plus haut que la case b
+// sur un niveau min (max = 0) ou sur un niveau max (max = 1)
+static int Tas_mm_avant(Heap h, size_t a, size_t b, int max){
+	int c = h->compare(h->heap[a], h->heap[b]);
+	INSTR_COMPTER(INSTR_TAS, comparaisons, 1);
+	return max ? c > 0 : c < 0;
+}
+
+// Mode min-max : remonte la case i, d'abord au-dessus de son pere si elle
+// appartient aux niveaux de l'autre sorte, puis de grand-pere en grand-pere
+static void Tas_mm_remonter(Heap h, size_t i){
+	if(i == 0)
+		return;
+	int max = Tas_niveau_max(i);
+	size_t pere = (i-1)/2;
+	if(Tas_mm_avant(h, i, pere, !max)){
+		Tas_echanger(h, i, pere);
+		i = pere;
+		max = !max;
+	}
+	while(i > 2){
+		size_t grand_pere = ((i-1)/2-1)/2;
+		if(!Tas_mm_avant(h, i, grand_pere, max))
+			break;
+		Tas_echanger(h, i, grand_pere);
+		i = grand_pere;
+	}
+}
+
+// Mode min-max : descend la case i vers le meilleur de ses fils et petits-fils
+static void Tas_mm_descendre(Heap h, size_t i){
+	int max = Tas_niveau_max(i);
+	while(2*i+1 < h->size){
+		size_t m = 2*i+1;
+		size_t candidats[5] = { 2*i+2, 4*i+3, 4*i+4, 4*i+5, 4*i+6 };
+		for(int k = 0; k < 5 && candidats[k] < h->size; k++){
+			if(Tas_mm_avant(h, candidats[k], m, max))
+				m = candidats[k];
+		}
+		if(!Tas_mm_avant(h, m, i, max))
+			break;
+		Tas_echanger(h, m, i);
+		if(m <= 2*i+2)
+			break; // un fils n'a que des descendants de l'autre sorte en dessous de lui
+		size_t pere = (m-1)/2;
+		if(Tas_mm_avant(h, m, pere, !max))
+			Tas_echanger(h, m, pere);
+		i = m;
+	}
+}
+
+// Mode min-max : enleve la case i, la derniere prend sa place
+static void Tas_mm_enlever(Heap h, size_t i){
+	h->size--;
+	if(i < h->size){
+		h->heap[i] = h->heap[h->size];
+		if(h->morts)
+			h->morts[i] = h->morts[h->size];
+		Tas_mm_remonter(h, i);
+		Tas_mm_descendre(h, i);
+	}
+}
+
+// Fait remonter la case i tant qu'elle doit sortir avant son pere
+static void Tas_remonter(Heap h, size_t i){
+	if(h->minmax){
+		Tas_mm_remonter(h, i);
+		return;
+	}
+	void* val = h->heap[i];
+	unsigned char mort = h->morts ? h->morts[i] : 0; // la marque suit la valeur
+	size_t nb_cmp = 0;
+	while(i > 0){
+		size_t pere = (i-1)/2;
+		nb_cmp++;
+		if(h->compare(val, h->heap[pere]) >= 0)
+			break;
+		h->heap[i] = h->heap[pere];
+		if(h->morts)
+			h->morts[i] = h->morts[pere];
+		i = pere;
+	}
+	h->heap[i] = val;
+	if(h->morts)
+		h->morts[i] = mort;
+	INSTR_COMPTER(INSTR_TAS, comparaisons, nb_cmp);
+}
+
+// Fait descendre la case i tant qu'un de ses fils doit sortir avant elle
+static void Tas_descendre(Heap h, size_t i){
+	if(h->minmax){
+		Tas_mm_descendre(h, i);
+		return;
+	}
+	void* val = h->heap[i];
+	unsigned char mort = h->morts ? h->morts[i] : 0;
+	size_t fils;
+	size_t nb_cmp = 0;
+	while((fils = 2*i+1) < h->size){
+		// Les quatre petits-fils sont voisins : on les charge pendant la
+		// comparaison des fils, dont le gagnant sera compare a eux ensuite
+		if(2*fils+1 < h->size)
+			__builtin_prefetch(&h->heap[2*fils+1]);
+		if(fils+1 < h->size){
+			nb_cmp++;
+			if(h->compare(h->heap[fils+1], h->heap[fils]) < 0)
+				fils++;
+		}
+		nb_cmp++;
+		if(h->compare(h->heap[fils], val) >= 0)
+			break;
+		h->heap[i] = h->heap[fils];
+		if(h->morts)
+			h->morts[i] = h->morts[fils];
+		i = fils;
+	}
+	h->heap[i] = val;
+	if(h->morts)
+		h->morts[i] = mort;
+	INSTR_COMPTER(INSTR_TAS, comparaisons, nb_cmp);
+}
+
+void Tas_finaliser(struct heap_struct* h){
+	if(h->fd >= 0){
+		Tas_compacter(h); // les marques ne sont pas dans le fichier
+		Tas_publier(h);
+		munmap(h->entete, Tas_taille_projection(h->capacite));
+		close(h->fd);
+		h->fd = -1;
+		h->entete = NULL;
+	}
+	else if(h->reserve > 0){
+		munmap(h->heap, h->reserve*sizeof(void*));
+	}
+	else if(h->heap != NULL && h->heap != h->petit){
+		Recyclage_rendre(h->heap, h->capacite*sizeof(void*));
+	}
+	h->heap = NULL;
+	h->reserve = 0;
+	h->size = 0;
+	h->capacite = 0;
+	free(h->morts);
+	h->morts = NULL;
+	h->nb_morts = 0;
+}
 
 Heap Tas_detruire(Heap h){//ALGO POUR LES FREE()
 	if(h != NULL){
-		if(h->heap != NULL){
-			free(h->heap);
-			h->heap = NULL;
-		}
-		free(h);
+		TRACE(TRACE_TAS_DETRUIRE, h, 0);
+		Tas_finaliser(h);
+		Recyclage_rendre(h, sizeof(struct heap_struct));
 		h = NULL;
 	}
 	return h;
 }
 
 
-// Constructeur 
-Heap Tas_creer(size_t nb){
-	Heap h;
-
-	if((h = malloc(sizeof(struct heap_struct))) == NULL){
-		fprintf(stderr, "errueut lors de l'allocation de memoir de la structure");
-		exit(1);
-	}
+void Tas_initialiser(struct heap_struct* h, size_t nb){
 	h->size=nb;
+	h->fd = -1;
+	h->entete = NULL;
+	h->compare = NULL;
+	h->morts = NULL;
+	h->nb_morts = 0;
+	h->seuil = TAS_SEUIL_DEFAUT;
+	h->borne = 0;
+	h->minmax = 0;
+	h->reserve = 0;
 	if(nb < 1)
 		h->capacite=1;
 	else
 		h->capacite=h->size*2;
-	if((h->heap = malloc(h->capacite*sizeof(void*))) == NULL){
+	if((h->heap = Tas_allouer_cases(h)) == NULL){
 		fprintf(stderr, "errueut lors de l'allocation de memoir du tas");
-		h=Tas_detruire(h);
 		exit(1);
 	}
+}
+
+// Constructeur 
+Heap Tas_creer(size_t nb){
+	Heap h;
+
+	if((h = Recyclage_prendre(sizeof(struct heap_struct))) == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir de la structure");
+		exit(1);
+	}
+	Tas_initialiser(h, nb);
+	INSTR_COMPTER(INSTR_TAS, allocations, 1);
+	TRACE(TRACE_TAS_CREER, h, 0);
 //	printf("%s  :   le pointeur est de %p\n", __FUNCTION__, h);
 	return h;
 }
 
 
+Heap Tas_creerBorne(size_t k, Tas_comparateur cmp){
+	if(k < 1 || cmp == NULL){
+		fprintf(stderr, "un tas borne demande k >= 1 et un comparateur\n");
+		exit(1);
+	}
+	Heap h = Tas_creer(0);
+	h->compare = cmp;
+	Tas_fixer_borne(h, k); // la seule allocation du tableau
+	return h;
+}
+
+
+void Tas_fixer_borne(Heap h, size_t k){
+	if(k > 0 && h->compare == NULL){
+		fprintf(stderr, "un tas borne demande un comparateur\n");
+		exit(1);
+	}
+	if(k > 0){
+		Tas_compacter(h);
+		while(h->size > k)
+			Tas_extraire(h);
+		Tas_reserver(h, k);
+	}
+	h->borne = k;
+	TRACE(TRACE_TAS_BORNER, h, k);
+}
+
+
+Heap Tas_creerGrand(size_t reserve){
+	Heap h;
+
+	if((h = Recyclage_prendre(sizeof(struct heap_struct))) == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir de la structure");
+		exit(1);
+	}
+	Tas_initialiser(h, 0);
+	h->reserve = Tas_arrondir_geante(reserve < 1 ? 1 : reserve);
+	if((h->heap = Tas_reserver_espace(h->reserve)) == NULL){
+		fprintf(stderr, "erreur lors de la reservation de l'espace du tas");
+		exit(1);
+	}
+	h->capacite = 0;
+	Tas_engager(h, 1);	// une premiere page geante
+	INSTR_COMPTER(INSTR_TAS, allocations, 1);
+	TRACE(TRACE_TAS_CREER, h, 0);
+	return h;
+}
+
+
 // Constructeur par copie des elements de h2 dans h1.
 Heap Tas_creerTasParCopie(Heap h2){
 	Heap h;
-	if((h = malloc(sizeof(struct heap_struct))) == NULL){
+	INSTR_DEBUT(debut);
+	if((h = Recyclage_prendre(sizeof(struct heap_struct))) == NULL){
 		fprintf(stderr, "errueut lors de l'allocation de memoir de la structure");
 		exit(1);
 	}
+	Tas_initialiser(h, 0);	// un tas vide si h2 est NULL, et la copie est un tas ordinaire (pas grand)
 	if(h2){
+		h->compare = h2->compare;
+		h->seuil = h2->seuil;
+		h->borne = h2->borne;
+		h->minmax = h2->minmax;
 
 		h->size = h2->size;
 		h->capacite = h2->capacite;
 
-		if((h->heap = malloc(h->capacite*sizeof(void*))) == NULL){
+		if((h->heap = Tas_allouer_cases(h)) == NULL){
 			fprintf(stderr, "errueut lors de l'allocation de memoir du tas");
 			h=Tas_detruire(h);
 			exit(1);
@@ -66,7 +486,21 @@ Heap Tas_creerTasParCopie(Heap h2){
 
 		for(size_t i=0; i<h->size; i++)
 			h->heap[i] = h2->heap[i];
+		if(h2->nb_morts > 0){
+			// La copie ne garde que les cases vivantes
+			if((h->morts = malloc(h->capacite)) == NULL){
+				fprintf(stderr, "errueut lors de l'allocation de memoir du tas");
+				exit(1);
+			}
+			memcpy(h->morts, h2->morts, h->size);
+			h->nb_morts = h2->nb_morts;
+			Tas_compacter(h);
+		}
+		INSTR_COMPTER(INSTR_TAS, octets_deplaces, h->size * sizeof(void*));
 	}
+	INSTR_COMPTER(INSTR_TAS, allocations, 1);
+	INSTR_FIN(INSTR_TAS, INSTR_COPIE, debut);
+	TRACE(TRACE_TAS_COPIER, h, (uintptr_t)h2);
 	return h;
 }
 
@@ -75,9 +509,8 @@ void Tas_afficher(Heap h){
 	//printf("%s  :   le pointeur est de %p\n", __FUNCTION__, h);
 	if(h != NULL){
 		//printf("size a une valeur de %zu\nLa capacite est de %zu\nLes valeur sont: \n", h->size, h->capacite);
-		for(size_t i = 0; i<h->size; i++)
-			printf("%d ", (int)h->heap[i]);
-		printf("\n");
+		fflush(stdout); // on ecrit directement sur le descripteur
+		Tas_ecrire_texte(h, STDOUT_FILENO, Tas_formater_entier);
 	}
 }
 
@@ -85,59 +518,758 @@ size_t Tas_taille(const Heap h){
 	return h->size;
 }
 
+size_t Tas_nb_morts(const Heap h){
+	return h->nb_morts;
+}
+
+// Ajoute val dans une case libre (la capacite doit suffire)
+static void Tas_empiler(Heap h, void* val){
+	h->heap[h->size] = val;
+	if(h->morts)
+		h->morts[h->size] = 0;
+	h->size++;
+	if(h->compare)
+		Tas_remonter(h, h->size-1);
+	Tas_publier(h);
+}
+
 void Tas_ajouter_valeur(Heap h, void* val){
+	if(h && h->borne){
+		Tas_proposer(h, val, NULL); // enregistre TRACE_TAS_PROPOSER
+		return;
+	}
+	INSTR_DEBUT(debut);
 	if(h){
-		if(h->size == h->capacite){
-			h->capacite*=2; //On  double la capacite
-			h->heap = realloc(h->heap, h->capacite * sizeof(void*));
-		}
+		if(h->size == h->capacite)
+			Tas_reserver(h, h->capacite*2); //On  double la capacite
 	}
 	else{
 		h = Tas_creer(0);
 	}
-	h->size++;
-	h->heap[h->size-1] = val;
+	Tas_empiler(h, val);
+	INSTR_FIN(INSTR_TAS, INSTR_AJOUT, debut);
+	TRACE(TRACE_TAS_AJOUTER, h, (uintptr_t)val);
+}
+
+/*
+ * Tas_proposer sur un tas borne, sans evenement de trace : Tas_concatener
+ * s'en sert pour n'enregistrer que TRACE_TAS_CONCATENER.
+ */
+static int Tas_offrir(Heap h, void* val, void** sortie){
+	INSTR_DEBUT(debut);
+	if(h->size == h->borne)
+		Tas_compacter(h); // les cases mortes laissent de la place
+	if(h->size < h->borne){
+		Tas_empiler(h, val);
+		INSTR_FIN(INSTR_TAS, INSTR_AJOUT, debut);
+		return 0;
+	}
+	INSTR_COMPTER(INSTR_TAS, comparaisons, 1);
+	if(h->compare(val, h->heap[0]) <= 0){
+		// Rejet en O(1) : val ne sort pas apres la plus petite valeur gardee
+		if(sortie)
+			*sortie = val;
+		INSTR_FIN(INSTR_TAS, INSTR_AJOUT, debut);
+		return 1;
+	}
+	if(sortie)
+		*sortie = h->heap[0];
+	h->heap[0] = val;
+	if(h->morts)
+		h->morts[0] = 0;
+	Tas_descendre(h, 0);
+	Tas_publier(h);
+	INSTR_FIN(INSTR_TAS, INSTR_AJOUT, debut);
+	return 1;
+}
+
+int Tas_proposer(Heap h, void* val, void** sortie){
+	if(h->borne == 0){
+		Tas_ajouter_valeur(h, val);
+		return 0;
+	}
+	TRACE(TRACE_TAS_PROPOSER, h, (uintptr_t)val);
+	return Tas_offrir(h, val, sortie);
+}
+
+/*
+ * Morceau du tableau traite par un fil de Tas_selectionner.
+ */
+struct tas_morceau{
+	void** valeurs;
+	size_t n;
+	Heap h;
+};
+
+static void* Tas_selectionner_morceau(void* arg){
+	struct tas_morceau* m = arg;
+	for(size_t i = 0; i < m->n; i++)
+		Tas_proposer(m->h, m->valeurs[i], NULL);
+	return NULL;
+}
+
+Heap Tas_selectionner(void** valeurs, size_t n, size_t k, Tas_comparateur cmp, unsigned nb_fils){
+	struct tas_morceau* morceaux;
+	pthread_t* fils;
+
+	if(nb_fils < 1)
+		nb_fils = 1;
+	if((morceaux = malloc(nb_fils*sizeof(struct tas_morceau))) == NULL
+			|| (fils = malloc(nb_fils*sizeof(pthread_t))) == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir du tas");
+		exit(1);
+	}
+	for(unsigned i = 0; i < nb_fils; i++){
+		size_t debut = n*i/nb_fils;
+		morceaux[i].valeurs = valeurs + debut;
+		morceaux[i].n = n*(i+1)/nb_fils - debut;
+		morceaux[i].h = Tas_creerBorne(k, cmp);
+	}
+	// Le fil appelant traite le premier morceau
+	for(unsigned i = 1; i < nb_fils; i++){
+		if(pthread_create(&fils[i], NULL, Tas_selectionner_morceau, &morceaux[i]) != 0){
+			fprintf(stderr, "erreur lors de la creation d'un fil\n");
+			exit(1);
+		}
+	}
+	Tas_selectionner_morceau(&morceaux[0]);
+	for(unsigned i = 1; i < nb_fils; i++){
+		pthread_join(fils[i], NULL);
+		Tas_concatener(morceaux[0].h, morceaux[i].h);
+		Tas_detruire(morceaux[i].h);
+	}
+
+	Heap h = morceaux[0].h;
+	free(morceaux);
+	free(fils);
+	return h;
 }
 
 Heap Tas_concatener(Heap h, const Heap h2){
+	INSTR_DEBUT(debut);
+	INSTR_COMPTER(INSTR_TAS, octets_deplaces, h2->size * sizeof(void*));
 	if(!h){
 		h=Tas_creer(h2->size);
-		h->capacite = h2->capacite;
+		h->compare = h2->compare;
+		h->minmax = h2->minmax; // la copie garde la disposition de h2
+		h->size = 0;
 		for (size_t i = 0; i < h2->size; i++){
-			h->heap[i] = h2->heap[i];
+			if(h2->nb_morts == 0 || !h2->morts[i])
+				h->heap[h->size++] = h2->heap[i];
+		}
+		if(h2->nb_morts > 0)
+			Tas_tasser(h);
+	}
+	else if(h->borne){
+		if(h2 != h){
+			for(size_t i = 0; i < h2->size; i++){
+				if(h2->nb_morts == 0 || !h2->morts[i])
+					Tas_offrir(h, h2->heap[i], NULL);
+			}
 		}
 	}
 	else{
-		h->size += h2->size; 
-		h->capacite += h2->capacite;
-		h->heap = realloc(h->heap, (h->size + h2->size) * sizeof(void*));
-		for(size_t i = (h->size - h2->size), j=0 ; i<h->size; i++, j++){
-			h->heap[i] = h2->heap[j];
+		size_t n = h2->size; // h2 peut etre h lui-meme
+		size_t i = h->size;
+		Tas_reserver(h, h->size + n);
+		for(size_t j=0 ; j<n; j++){
+			if(h2->nb_morts == 0 || !h2->morts[j])
+				h->heap[i++] = h2->heap[j];
 		}
+		if(h->morts)
+			memset(h->morts + h->size, 0, i - h->size);
+		h->size = i;
+		Tas_tasser(h); // les valeurs de h2 sont ajoutees en vrac
+		Tas_publier(h);
 	}
+	INSTR_FIN(INSTR_TAS, INSTR_CONCATENATION, debut);
+	TRACE(TRACE_TAS_CONCATENER, h, (uintptr_t)h2);
 	return h;
 }
 
+void Tas_vider(Heap h){
+	// Les marques des cases reutilisees sont remises a zero par Tas_empiler
+	h->size = 0;
+	h->nb_morts = 0;
+	Tas_publier(h);
+	TRACE(TRACE_TAS_VIDER, h, 0);
+}
+
 int Tas_estVide(Heap h){
-	return h->size==0;
+	return h->size==h->nb_morts;
 }
 
 Heap Tas_enlever_valeur(size_t position, Heap h){
-	if(h->size <position){
+	if(position >= h->size){
+		fprintf(stderr, "l'indice est trop eleve %zu %zu\n", h->size, position);
+		exit(1);
+	}
+	INSTR_DEBUT(debut);
+	if(h->morts && h->morts[position])
+		h->nb_morts--;
+	h->size--;
+	if(h->compare == NULL){
+		// Simple tableau : on decale la fin pour garder l'ordre
+		memmove(h->heap+position, h->heap+position+1, (h->size-position)*sizeof(void*));
+		if(h->morts)
+			memmove(h->morts+position, h->morts+position+1, h->size-position);
+		INSTR_COMPTER(INSTR_TAS, octets_deplaces, (h->size-position) * sizeof(void*));
+	}
+	else if(position < h->size){
+		// La derniere case prend la place puis remonte ou descend
+		h->heap[position] = h->heap[h->size];
+		if(h->morts)
+			h->morts[position] = h->morts[h->size];
+		if(h->minmax){
+			Tas_mm_remonter(h, position);
+			Tas_mm_descendre(h, position);
+		}
+		else if(position > 0 && h->compare(h->heap[position], h->heap[(position-1)/2]) < 0)
+			Tas_remonter(h, position);
+		else
+			Tas_descendre(h, position);
+	}
+	Tas_publier(h);
+	INSTR_FIN(INSTR_TAS, INSTR_SUPPRESSION, debut);
+	TRACE(TRACE_TAS_ENLEVER, h, position);
+	return h;
+}
+
+void Tas_marquer_mort(Heap h, size_t position){
+	if(position >= h->size){
 		fprintf(stderr, "l'indice est trop eleve %zu %zu\n", h->size, position);
 		exit(1);
 	}
-	Heap htemp;
-	htemp = Tas_creer(h->size-1);
+	if(h->morts == NULL){
+		if((h->morts = calloc(h->capacite, 1)) == NULL){
+			fprintf(stderr, "errueut lors de l'allocation de memoir du tas");
+			exit(1);
+		}
+		INSTR_COMPTER(INSTR_TAS, allocations, 1);
+	}
+	if(h->morts[position])
+		return;
+	h->morts[position] = 1;
+	h->nb_morts++;
+	if(h->nb_morts > h->seuil * h->size)
+		Tas_compacter(h);
+}
+
+void Tas_compacter(Heap h){
+	if(h->nb_morts == 0)
+		return;
+	size_t j = 0;
+	for(size_t i = 0; i < h->size; i++){
+		if(!h->morts[i])
+			h->heap[j++] = h->heap[i];
+	}
+	INSTR_COMPTER(INSTR_TAS, octets_deplaces, j * sizeof(void*));
+	memset(h->morts, 0, h->size);
+	h->size = j;
+	h->nb_morts = 0;
+	Tas_tasser(h);
+	Tas_publier(h);
+}
+
+void Tas_fixer_seuil(Heap h, double seuil){
+	h->seuil = seuil;
+}
+
+
+Heap Tas_ouvrirPersistant(const char* chemin, size_t nb){
+	Heap h;
+	struct stat st;
+	struct tas_entete entete;
+
+	if((h = Recyclage_prendre(sizeof(struct heap_struct))) == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir de la structure");
+		exit(1);
+	}
+	if((h->fd = open(chemin, O_RDWR | O_CREAT, 0644)) < 0 || fstat(h->fd, &st) != 0){
+		perror(chemin);
+		goto echec;
+	}
+
+	if(st.st_size == 0){
+		// Nouveau fichier : on ecrit un en-tete vide
+		memset(&entete, 0, sizeof(entete));
+		memcpy(entete.magique, TAS_MAGIQUE, sizeof(TAS_MAGIQUE));
+		entete.version = TAS_VERSION;
+		entete.taille_enreg = sizeof(void*);
+		entete.capacite = (nb < 1) ? 1 : nb;
+		if(ftruncate(h->fd, Tas_taille_projection(entete.capacite)) != 0
+				|| pwrite(h->fd, &entete, sizeof(entete), 0) != (ssize_t)sizeof(entete)){
+			perror(chemin);
+			goto echec;
+		}
+		st.st_size = Tas_taille_projection(entete.capacite);
+	}
+	else if((size_t)st.st_size < sizeof(entete) || pread(h->fd, &entete, sizeof(entete), 0) != (ssize_t)sizeof(entete)){
+		fprintf(stderr, "%s : fichier de tas tronque\n", chemin);
+		goto echec;
+	}
+
+	if(memcmp(entete.magique, TAS_MAGIQUE, sizeof(TAS_MAGIQUE)) != 0 || entete.version != TAS_VERSION
+			|| entete.taille_enreg != sizeof(void*) || entete.size > entete.capacite
+			|| (uint64_t)st.st_size < Tas_taille_projection(entete.capacite)){
+		fprintf(stderr, "%s : ce n'est pas un tas persistant valide\n", chemin);
+		goto echec;
+	}
+
+	if(Tas_projeter(h, entete.capacite) != 0){
+		perror(chemin);
+		goto echec;
+	}
+	h->size = entete.size;
+	h->compare = NULL;
+	h->morts = NULL;
+	h->nb_morts = 0;
+	h->seuil = TAS_SEUIL_DEFAUT;
+	h->borne = 0;
+	h->minmax = 0;
+	h->reserve = 0;
+	return h;
+
+echec:
+	if(h->fd >= 0)
+		close(h->fd);
+	Recyclage_rendre(h, sizeof(struct heap_struct));
+	return NULL;
+}
+
+int Tas_synchroniser(Heap h){
+	if(h == NULL || h->fd < 0)
+		return -1;
+	Tas_compacter(h);
+	Tas_publier(h);
+	return msync(h->entete, Tas_taille_projection(h->capacite), MS_SYNC);
+}
+
+void Tas_fixer_comparateur(Heap h, Tas_comparateur cmp){
+	h->compare = cmp;
+}
+
+void Tas_tasser(Heap h){
+	if(h->compare == NULL || h->size < 2)
+		return;
+	for(size_t i = h->size/2; i-- > 0; )
+		Tas_descendre(h, i);
+}
+
+// Enleve la case du sommet sans la regarder
+static void Tas_enlever_sommet(Heap h){
+	h->size--;
+	if(h->size > 0){
+		h->heap[0] = h->heap[h->size];
+		if(h->morts)
+			h->morts[0] = h->morts[h->size];
+		if(h->compare)
+			Tas_descendre(h, 0);
+	}
+}
+
+// Enleve les cases mortes arrivees au sommet
+static void Tas_purger(Heap h){
+	if(h->nb_morts == 0)
+		return;
+	while(h->size > 0 && h->morts[0]){
+		h->nb_morts--;
+		Tas_enlever_sommet(h);
+	}
+	Tas_publier(h);
+}
+
+void* Tas_sommet(Heap h){
+	Tas_purger(h);
+	if(h->size == 0){
+		fprintf(stderr, "le tas est vide\n");
+		exit(1);
+	}
+	return h->heap[0];
+}
+
+void* Tas_extraire(Heap h){
+	INSTR_DEBUT(debut);
+	void* val = Tas_sommet(h);
+	Tas_enlever_sommet(h);
+	Tas_publier(h);
+	INSTR_FIN(INSTR_TAS, INSTR_EXTRACTION, debut);
+	TRACE(TRACE_TAS_EXTRAIRE, h, 0);
+	return val;
+}
+
+void Tas_fixer_minmax(Heap h, int actif){
+	if(actif && h->compare == NULL){
+		fprintf(stderr, "le mode min-max demande un comparateur\n");
+		exit(1);
+	}
+	h->minmax = actif ? 1 : 0;
+	Tas_tasser(h);
+}
+
+void* Tas_min(Heap h){
+	return Tas_sommet(h);
+}
+
+void* Tas_extraire_min(Heap h){
+	return Tas_extraire(h);
+}
+
+// Indice de la plus grande valeur d'un tas min-max non vide
+static size_t Tas_indice_max(const Heap h){
+	if(h->size < 3)
+		return h->size - 1;
+	INSTR_COMPTER(INSTR_TAS, comparaisons, 1);
+	return (h->compare(h->heap[2], h->heap[1]) > 0) ? 2 : 1;
+}
+
+void* Tas_max(Heap h){
+	if(!h->minmax){
+		fprintf(stderr, "le tas n'est pas en mode min-max\n");
+		exit(1);
+	}
+	// Enleve les cases mortes arrivees a la place du maximum
+	while(h->nb_morts > 0 && h->size > 0 && h->morts[Tas_indice_max(h)]){
+		h->nb_morts--;
+		Tas_mm_enlever(h, Tas_indice_max(h));
+	}
+	if(h->size == 0){
+		fprintf(stderr, "le tas est vide\n");
+		exit(1);
+	}
+	Tas_publier(h);
+	return h->heap[Tas_indice_max(h)];
+}
+
+void* Tas_extraire_max(Heap h){
+	INSTR_DEBUT(debut);
+	void* val = Tas_max(h);
+	Tas_mm_enlever(h, Tas_indice_max(h));
+	Tas_publier(h);
+	INSTR_FIN(INSTR_TAS, INSTR_EXTRACTION, debut);
+	return val;
+}
+
+// Indice de la premiere case de t[0..n) egale a val, n si aucune
+static size_t Tas_chercher_mot(void* const* t, size_t n, const void* val){
+	size_t i = 0;
+	while(i < n && t[i] != val)
+		i++;
+	return i;
+}
+
+static size_t Tas_compter_mot(void* const* t, size_t n, const void* val){
+	size_t nb = 0;
+	for(size_t i = 0; i < n; i++)
+		nb += (t[i] == val);
+	return nb;
+}
+
+#ifdef TAS_AVX2
+__attribute__((target("avx2")))
+static size_t Tas_chercher_mot_avx2(void* const* t, size_t n, const void* val){
+	__m256i cle = _mm256_set1_epi64x((long long)(intptr_t)val);
+	size_t i = 0;
+	for(; i + 4 <= n; i += 4){
+		__m256i v = _mm256_loadu_si256((const __m256i*)(t+i));
+		int masque = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, cle)));
+		if(masque)
+			return i + __builtin_ctz(masque);
+	}
+	return i + Tas_chercher_mot(t+i, n-i, val);
+}
+
+__attribute__((target("avx2")))
+static size_t Tas_compter_mot_avx2(void* const* t, size_t n, const void* val){
+	__m256i cle = _mm256_set1_epi64x((long long)(intptr_t)val);
+	__m256i somme = _mm256_setzero_si256();
+	size_t i = 0;
+	// Une case egale vaut -1 dans le resultat de la comparaison
+	for(; i + 4 <= n; i += 4){
+		__m256i v = _mm256_loadu_si256((const __m256i*)(t+i));
+		somme = _mm256_sub_epi64(somme, _mm256_cmpeq_epi64(v, cle));
+	}
+	uint64_t lanes[4];
+	_mm256_storeu_si256((__m256i*)lanes, somme);
+	return (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]) + Tas_compter_mot(t+i, n-i, val);
+}
+#endif
+
+static size_t Tas_chercher(void* const* t, size_t n, const void* val){
+#ifdef TAS_AVX2
+	if(__builtin_cpu_supports("avx2"))
+		return Tas_chercher_mot_avx2(t, n, val);
+#endif
+	return Tas_chercher_mot(t, n, val);
+}
+
+size_t Tas_trouver(const Heap h, const void* val){
+	size_t i = 0;
+	for(;;){
+		i += Tas_chercher(h->heap+i, h->size-i, val);
+		if(i == h->size)
+			return TAS_ABSENT;
+		if(h->nb_morts == 0 || !h->morts[i])
+			return i;
+		i++; // case morte : on continue apres elle
+	}
+}
+
+size_t Tas_compter_egaux(const Heap h, const void* val){
+	if(h->nb_morts > 0){
+		size_t nb = 0;
+		for(size_t i = 0; i < h->size; i++)
+			nb += (h->heap[i] == val && !h->morts[i]);
+		return nb;
+	}
+#ifdef TAS_AVX2
+	if(__builtin_cpu_supports("avx2"))
+		return Tas_compter_mot_avx2(h->heap, h->size, val);
+#endif
+	return Tas_compter_mot(h->heap, h->size, val);
+}
+
+size_t Tas_supprimer_egaux(Heap h, const void* val){
+	size_t lu = 0, ecrit = 0;
 
-	size_t j=0;
-	for (size_t i = 0; i < h->size; ++i){
-		if(i == position)
+	Tas_compacter(h); // les marques ne suivraient pas les morceaux deplaces
+	while(lu < h->size){
+		// Le morceau [lu, k) est garde, la case k est enlevee
+		size_t k = lu + Tas_chercher(h->heap+lu, h->size-lu, val);
+		if(ecrit != lu)
+			memmove(h->heap+ecrit, h->heap+lu, (k-lu)*sizeof(void*));
+		INSTR_COMPTER(INSTR_TAS, octets_deplaces, (ecrit != lu) ? (k-lu)*sizeof(void*) : 0);
+		ecrit += k-lu;
+		lu = k+1;
+	}
+	size_t nb = h->size - ecrit;
+	h->size = ecrit;
+	if(nb > 0)
+		Tas_tasser(h);
+	Tas_publier(h);
+	return nb;
+}
+
+size_t Tas_compter_si(const Heap h, Tas_predicat p, void* contexte){
+	size_t nb = 0;
+	for(size_t i = 0; i < h->size; i++){
+		if((h->nb_morts == 0 || !h->morts[i]) && p(h->heap[i], contexte))
+			nb++;
+	}
+	return nb;
+}
+
+size_t Tas_supprimer_si(Heap h, Tas_predicat p, void* contexte){
+	size_t j = 0, nb = 0;
+	for(size_t i = 0; i < h->size; i++){
+		if(h->nb_morts > 0 && h->morts[i])
 			continue;
+		if(p(h->heap[i], contexte))
+			nb++;
 		else
-			htemp->heap[j++]=h->heap[i];
+			h->heap[j++] = h->heap[i];
+	}
+	INSTR_COMPTER(INSTR_TAS, octets_deplaces, j * sizeof(void*));
+	if(h->nb_morts > 0)
+		memset(h->morts, 0, h->size);
+	if(j != h->size){
+		h->size = j;
+		h->nb_morts = 0;
+		Tas_tasser(h);
+		Tas_publier(h);
+	}
+	return nb;
+}
+
+void Tas_pour_chaque(const Heap h, Tas_action f, void* contexte){
+	for(size_t i = 0; i < h->size; i++){
+		if(h->nb_morts == 0 || !h->morts[i])
+			f(h->heap[i], contexte);
+	}
+}
+
+int Tas_comparer_entiers(const void* a, const void* b){
+	intptr_t x = (intptr_t)a, y = (intptr_t)b;
+	return (x > y) - (x < y);
+}
+
+// Taille du tampon de Tas_ecrire_texte
+#define TAS_TAMPON_TEXTE 65536
+
+static const char Tas_chiffres[201] =
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+size_t Tas_formater_entier(char* tampon, const void* valeur){
+	intptr_t x = (intptr_t)valeur;
+	uintptr_t u = (x < 0) ? -(uintptr_t)x : (uintptr_t)x;
+	char chiffres[24];
+	size_t n = sizeof(chiffres);
+	size_t k = 0;
+
+	// Deux chiffres a la fois, de droite a gauche
+	while(u >= 100){
+		unsigned d = (unsigned)(u % 100) * 2;
+		u /= 100;
+		chiffres[--n] = Tas_chiffres[d+1];
+		chiffres[--n] = Tas_chiffres[d];
+	}
+	if(u >= 10){
+		chiffres[--n] = Tas_chiffres[u*2+1];
+		chiffres[--n] = Tas_chiffres[u*2];
 	}
-	return htemp;
+	else
+		chiffres[--n] = '0' + (char)u;
+
+	if(x < 0)
+		tampon[k++] = '-';
+	memcpy(tampon+k, chiffres+n, sizeof(chiffres)-n);
+	return k + sizeof(chiffres)-n;
+}
+
+// write() jusqu'au bout, en reprenant apres une ecriture partielle
+static int Tas_ecrire_tout(int fd, const void* buf, size_t n){
+	const char* p = buf;
+	while(n > 0){
+		ssize_t k = write(fd, p, n);
+		if(k < 0){
+			if(errno == EINTR)
+				continue;
+			return -1;
+		}
+		p += k;
+		n -= k;
+	}
+	return 0;
+}
+
+// read() jusqu'au bout, retourne -1 si le flux se termine avant
+static int Tas_lire_tout(int fd, void* buf, size_t n){
+	char* p = buf;
+	while(n > 0){
+		ssize_t k = read(fd, p, n);
+		if(k < 0 && errno == EINTR)
+			continue;
+		if(k <= 0)
+			return -1;
+		p += k;
+		n -= k;
+	}
+	return 0;
 }
 
+int Tas_ecrire(const Heap h, int fd){
+	struct tas_flux_entete entete;
 
+	memset(&entete, 0, sizeof(entete));
+	memcpy(entete.magique, TAS_FLUX_MAGIQUE, 4);
+	entete.version = TAS_FLUX_VERSION;
+	entete.taille_enreg = sizeof(void*);
+	entete.nb = h->size - h->nb_morts;
+
+	if(Tas_ecrire_tout(fd, &entete, sizeof(entete)) != 0)
+		return -1;
+	// Le tableau est contigu : on ecrit directement chaque suite de cases
+	// vivantes, sans recopie
+	for(size_t i = 0, debut = 0; i <= h->size; i++){
+		if(i < h->size && (h->nb_morts == 0 || !h->morts[i]))
+			continue;
+		if(i > debut && Tas_ecrire_tout(fd, h->heap+debut, (i-debut)*sizeof(void*)) != 0)
+			return -1;
+		debut = i+1;
+	}
+	return 0;
+}
+
+Heap Tas_lire(int fd, Tas_comparateur cmp){
+	struct tas_flux_entete entete;
+	Heap h;
+
+	if(Tas_lire_tout(fd, &entete, sizeof(entete)) != 0
+			|| memcmp(entete.magique, TAS_FLUX_MAGIQUE, 4) != 0
+			|| entete.version != TAS_FLUX_VERSION
+			|| entete.taille_enreg != sizeof(void*)
+			|| entete.nb > SIZE_MAX/(2*sizeof(void*))){	// le tableau a 2*nb cases
+		fprintf(stderr, "flux de tas invalide\n");
+		return NULL;
+	}
+
+	// Comme Tas_creer(entete.nb), mais un en-tete trop grand pour la memoire
+	// fait retourner NULL au lieu d'arreter le programme
+	if((h = Recyclage_prendre(sizeof(struct heap_struct))) == NULL){
+		fprintf(stderr, "pas assez de memoire pour relire le tas\n");
+		return NULL;
+	}
+	Tas_initialiser(h, 0);
+	h->size = entete.nb;
+	h->capacite = (entete.nb < 1) ? 1 : 2*entete.nb;
+	if((h->heap = Tas_allouer_cases(h)) == NULL){
+		fprintf(stderr, "pas assez de memoire pour relire le tas\n");
+		h->size = 0;
+		h->capacite = 0;
+		Recyclage_rendre(h, sizeof(struct heap_struct));
+		return NULL;
+	}
+	INSTR_COMPTER(INSTR_TAS, allocations, 1);
+	TRACE(TRACE_TAS_CREER, h, 0);
+	if(Tas_lire_tout(fd, h->heap, h->size*sizeof(void*)) != 0){
+		fprintf(stderr, "flux de tas tronque\n");
+		return Tas_detruire(h);
+	}
+	h->compare = cmp;
+	Tas_tasser(h);
+	return h;
+}
+
+int Tas_ecrire_texte(const Heap h, int fd, Tas_formateur f){
+	char tampon[TAS_TAMPON_TEXTE];
+	size_t n = 0;
+
+	for(size_t i = 0; i < h->size; i++){
+		if(h->nb_morts > 0 && h->morts[i])
+			continue;
+		// Place pour la valeur, son espace et le '\n' final
+		if(n + TAS_FORMAT_MAX + 2 > sizeof(tampon)){
+			if(Tas_ecrire_tout(fd, tampon, n) != 0)
+				return -1;
+			n = 0;
+		}
+		n += f(tampon+n, h->heap[i]);
+		tampon[n++] = ' ';
+	}
+	tampon[n++] = '\n';
+	return Tas_ecrire_tout(fd, tampon, n);
+}
+
+size_t Tas_formater(const Heap h, char* dest, size_t taille, Tas_formateur f){
+	char tmp[TAS_FORMAT_MAX+1];
+	size_t total = 0;
+
+	for(size_t i = 0; i <= h->size; i++){
+		size_t k;
+		if(i < h->size && h->nb_morts > 0 && h->morts[i])
+			continue;
+		if(i == h->size){
+			tmp[0] = '\n';
+			k = 1;
+		}
+		else if(total + TAS_FORMAT_MAX + 1 < taille){
+			// Assez de place : on formate directement dans dest
+			k = f(dest+total, h->heap[i]);
+			dest[total+k] = ' ';
+			total += k+1;
+			continue;
+		}
+		else{
+			k = f(tmp, h->heap[i]);
+			tmp[k++] = ' ';
+		}
+		if(total < taille)
+			memcpy(dest+total, tmp, (total+k < taille) ? k : taille-total);
+		total += k;
+	}
+	if(taille > 0)
+		dest[(total < taille) ? total : taille-1] = '\0';
+	return total;
+}
@@ -8,6 +8,58 @@
 #ifndef SOFIEN_STELLA__HEAP_H__
 #define SOFIEN_STELLA__HEAP_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
+
+/**
+ * \brief Fonction de comparaison des valeurs du tas.
+ *
+ * Recoit les deux valeurs stockees dans le tas (et non des pointeurs sur les cases).
+ * Retourne un entier negatif si a doit sortir avant b, 0 si elles sont equivalentes,
+ * un entier positif sinon.
+ */
+typedef int (*Tas_comparateur)(const void* a, const void* b);
+
+
+/**
+ * \brief Predicat des operations groupees (Tas_compter_si, Tas_supprimer_si).
+ *
+ * Recoit une valeur du tas et le contexte passe par l'appelant, retourne
+ * un entier non nul si la valeur est retenue.
+ */
+typedef int (*Tas_predicat)(const void* valeur, void* contexte);
+
+/**
+ * \brief Fonction appelee sur chaque valeur par Tas_pour_chaque.
+ */
+typedef void (*Tas_action)(void* valeur, void* contexte);
+
+/**
+ * \brief Indice retourne par Tas_trouver quand la valeur est absente.
+ */
+#define TAS_ABSENT ((size_t)-1)
+
+
+/**
+ * \brief Taille maximale du texte produit par un Tas_formateur pour une valeur.
+ */
+#define TAS_FORMAT_MAX 64
+
+/**
+ * \brief Fonction qui ecrit le texte d'une valeur du tas.
+ *
+ * Ecrit au plus TAS_FORMAT_MAX octets dans tampon (sans '\0') et retourne
+ * le nombre d'octets ecrits.
+ */
+typedef size_t (*Tas_formateur)(char* tampon, const void* valeur);
+
+
+/**
+ * \brief Nombre de cases du petit tampon place dans la structure du tas.
+ */
+#define TAS_PETIT 8
+
 
 /**
  * \struct heap_struct
@@ -17,11 +69,48 @@
  * On a une taille qui correspond a la taille visuel (par l'utilisateur) 
  * et la taille reel qui a ete allouee a la machine.
  *
+ * Tant que la capacite ne depasse pas TAS_PETIT, le tableau est le tampon
+ * petit de la structure : un petit tas ne coute qu'une allocation. La
+ * structure ne doit donc pas etre recopiee telle quelle (heap pointerait
+ * sur le tampon de l'original).
+ *
  */
 struct heap_struct{
 	size_t size;		/*!< Taille (manipulable) visible par l'utilisateur. */
 	size_t capacite;	/*!< Taille reel qui a ete allouee (elle est egale a deux ois taille de size). */
 	void ** heap;		/*!< Tableau dynamique qui constitu notre tas. */
+	int fd;			/*!< Descripteur du fichier projete en mode persistant, -1 sinon. */
+	struct tas_entete* entete;	/*!< En-tete du fichier projete en mode persistant, NULL sinon. */
+	Tas_comparateur compare;	/*!< Ordre du tas, NULL pour un simple tableau non ordonne. */
+	unsigned char* morts;	/*!< morts[i] vaut 1 si la case i est marquee supprimee, NULL tant qu'aucune ne l'a ete. */
+	size_t nb_morts;	/*!< Nombre de cases marquees supprimees. */
+	double seuil;		/*!< Proportion de cases mortes qui declenche un compactage. */
+	size_t borne;		/*!< Nombre maximal d'elements en mode borne (Tas_creerBorne), 0 sinon. */
+	int minmax;		/*!< 1 en mode min-max (Tas_fixer_minmax), 0 sinon. */
+	size_t reserve;		/*!< Cases reservees dans l'espace d'adresses en mode grand (Tas_creerGrand), 0 sinon. */
+	void* petit[TAS_PETIT];	/*!< Tableau des petits tas, heap pointe dessus tant qu'il suffit. */
+};
+
+/**
+ * \brief Seuil de compactage par defaut (voir Tas_fixer_seuil).
+ */
+#define TAS_SEUIL_DEFAUT 0.25
+
+/**
+ * \struct tas_entete
+ * \brief En-tete d'un tas persistant
+ *
+ * Debut du fichier projete en memoire par Tas_ouvrirPersistant. Le tableau
+ * du tas suit directement l'en-tete. Chaque case est un enregistrement de
+ * taille fixe (sizeof(void*)) qui contient la valeur elle-meme : un pointeur
+ * n'aurait plus de sens apres un redemarrage.
+ */
+struct tas_entete{
+	char magique[8];	/*!< Signature "BIBLTAS". */
+	uint32_t version;	/*!< Version du format. */
+	uint32_t taille_enreg;	/*!< Taille d'un enregistrement en octets. */
+	uint64_t size;		/*!< Nombre d'elements du tas. */
+	uint64_t capacite;	/*!< Nombre d'enregistrements que peut contenir le fichier. */
 };
 
 typedef struct heap_struct* Heap;
@@ -39,11 +128,89 @@ typedef struct heap_struct* Heap;
 Heap Tas_creer(size_t nb);
 
 
+/**
+ * \fn void Tas_initialiser(struct heap_struct* h, size_t nb)
+ * \brief Initialise un tas dans une structure fournie par l'appelant.
+ *
+ * La structure peut etre sur la pile ou dans une autre structure : seul
+ * le tableau est alloue, et seulement s'il depasse TAS_PETIT cases.
+ * Tas_creer est Tas_initialiser sur une structure prise dans le cache de
+ * Recyclage.h.
+ *
+ * \param h La structure a initialiser.
+ * \param nb Taille du tableau a allouer.
+ */
+void Tas_initialiser(struct heap_struct* h, size_t nb);
+
+
+/**
+ * \fn void Tas_finaliser(struct heap_struct* h)
+ * \brief Libere ce que possede un tas initialise par Tas_initialiser, sans liberer la structure.
+ *
+ * La structure peut ensuite etre reinitialisee.
+ *
+ * \param h Le tas a finaliser.
+ */
+void Tas_finaliser(struct heap_struct* h);
+
+
+/**
+ * \fn Heap Tas_creerBorne(size_t k, Tas_comparateur cmp)
+ * \brief Cree un tas borne qui garde les k plus grandes valeurs d'un flux.
+ *
+ * Le tableau de k cases est alloue une fois pour toutes. Tant que le tas
+ * n'est pas plein, un ajout est un ajout ordinaire ; ensuite la valeur est
+ * comparee au sommet (la plus petite valeur gardee) : elle est rejetee en
+ * O(1) si elle ne sort pas apres lui, sinon elle le remplace en O(log k).
+ * Pour garder les k plus petites valeurs, il suffit d'inverser cmp.
+ * Tas_extraire rend ensuite les valeurs gardees de la plus petite a la plus grande.
+ *
+ * \param k Nombre de valeurs a garder (au moins 1).
+ * \param cmp L'ordre des valeurs (non NULL).
+ * \return Un pointeur sur la structure tas.
+ */
+Heap Tas_creerBorne(size_t k, Tas_comparateur cmp);
+
+
+/**
+ * \fn void Tas_fixer_borne(Heap h, size_t k)
+ * \brief Passe un tas existant en mode borne (voir Tas_creerBorne), ou l'en sort.
+ *
+ * Si le tas a plus de k valeurs, les plus petites sont extraites jusqu'a
+ * ce qu'il en reste k.
+ *
+ * \param h Le tas (avec un comparateur si k > 0).
+ * \param k Nombre de valeurs a garder, 0 pour un tas ordinaire.
+ */
+void Tas_fixer_borne(Heap h, size_t k);
+
+
+/**
+ * \fn Heap Tas_creerGrand(size_t reserve)
+ * \brief Cree un tas vide pour un tres grand nombre de valeurs.
+ *
+ * L'espace d'adresses de reserve cases est reserve des la creation (mmap
+ * sans memoire derriere) et demande en pages geantes de 2 Mio (madvise
+ * MADV_HUGEPAGE, sans effet si le systeme ne les a pas). Le tableau ne
+ * bouge plus en grandissant : chaque agrandissement ne fait que rendre
+ * accessibles les pages suivantes, sans recopie. Il n'est recopie qu'une fois
+ * la reservation depassee, dans une reservation deux fois plus grande.
+ *
+ * Une reservation n'occupe pas de memoire : on peut la prendre tres
+ * au-dela de la taille attendue. Pour un petit tas, Tas_creer reste
+ * preferable (chaque tas grand occupe au moins une page geante).
+ *
+ * \param reserve Nombre de cases a reserver.
+ * \return Un pointeur sur la structure tas.
+ */
+Heap Tas_creerGrand(size_t reserve);
+
+
 /**
  * \fn Heap creerTasParCopie(Heap h)
  * \brief Fonction constructeur par copie pour creer un tas
  *
- * \param h Le tas a copier.
+ * \param h Le tas a copier, ou NULL pour un tas vide (comme Tas_creer(0)).
  * \return un pointeur sur la structure tas qui sera une copie de h.
  */
 Heap Tas_creerTasParCopie(Heap h);
@@ -63,15 +230,58 @@ Heap Tas_detruire(Heap h);
  * \fn void afficherTas(Heap h);
  * \brief Fonction qui affiche le tas sous forme d'un tableau.
  *
+ * Les valeurs sont affichees comme des entiers (voir Tas_formater_entier).
+ *
  * \param h Le tas a afficher.
  */
 void Tas_afficher(Heap h);
 
 
+/**
+ * \fn int Tas_ecrire_texte(const Heap h, int fd, Tas_formateur f)
+ * \brief Ecrit le tas en texte sur un descripteur de fichier.
+ *
+ * Chaque valeur est suivie d'un espace, puis une fin de ligne termine le tout.
+ * Le texte est prepare dans un grand tampon sur la pile et envoye par un seul
+ * write() par morceau : aucune allocation, aucun printf par element.
+ *
+ * \param h Le tas a ecrire.
+ * \param fd Le descripteur ou ecrire.
+ * \param f Le formateur des valeurs.
+ * \return 0 en cas de succes, -1 en cas d'erreur d'ecriture.
+ */
+int Tas_ecrire_texte(const Heap h, int fd, Tas_formateur f);
+
+
+/**
+ * \fn size_t Tas_formater(const Heap h, char* dest, size_t taille, Tas_formateur f)
+ * \brief Ecrit le meme texte que Tas_ecrire_texte dans un tampon memoire.
+ *
+ * Comme snprintf, le texte est tronque a taille-1 octets et toujours termine par '\0'.
+ *
+ * \param h Le tas a ecrire.
+ * \param dest Le tampon de destination.
+ * \param taille La taille du tampon.
+ * \param f Le formateur des valeurs.
+ * \return La longueur du texte complet (sans le '\0').
+ */
+size_t Tas_formater(const Heap h, char* dest, size_t taille, Tas_formateur f);
+
+
+/**
+ * \fn size_t Tas_formater_entier(char* tampon, const void* valeur)
+ * \brief Formateur pour des entiers stockes directement dans les cases ((void*)(intptr_t)x).
+ */
+size_t Tas_formater_entier(char* tampon, const void* valeur);
+
+
 /**
  * \fn size_t taille(const Heap h);
  * \brief Fonction retourne la taille du tableau de tas
  *
+ * Les cases marquees supprimees sont comptees : le nombre d'elements
+ * vivants est Tas_taille(h) - Tas_nb_morts(h).
+ *
  * \param h Le tas qui nous donnnera la taille.
  * \return La taille du tas.
  */
@@ -82,26 +292,78 @@ size_t Tas_taille(const Heap h);
  * \fn void ajouter_valeur(Heap h, void* val)
  * \brief Fonction qui ajoute une valeur dans le tas.
  * 
+ * En mode borne, la valeur qui sort du tas est perdue : utiliser
+ * Tas_proposer si elle doit etre liberee.
+ * 
  * \param h Le tas auquel on va lui ajouter une valeur.
  * \param val La valeur a ajouter.
  * \return Le tas avec la valeur ajoute.
  */
 void Tas_ajouter_valeur(Heap h, void* val);
 
+/**
+ * \fn int Tas_proposer(Heap h, void* val, void** sortie)
+ * \brief Ajoute une valeur a un tas borne et donne celle qui en sort.
+ *
+ * Sur un tas non borne, c'est Tas_ajouter_valeur.
+ *
+ * \param h Le tas.
+ * \param val La valeur proposee.
+ * \param sortie Recoit (si non NULL) la valeur sortie du tas : l'ancien
+ * sommet s'il a ete remplace, ou val elle-meme si elle a ete rejetee.
+ * \return 1 si une valeur est sortie du tas, 0 sinon.
+ */
+int Tas_proposer(Heap h, void* val, void** sortie);
+
+
+/**
+ * \fn Heap Tas_selectionner(void** valeurs, size_t n, size_t k, Tas_comparateur cmp, unsigned nb_fils)
+ * \brief Selection parallele des k plus grandes valeurs d'un tableau.
+ *
+ * Le tableau est coupe en nb_fils morceaux ; chaque fil remplit son propre
+ * tas borne, puis les tas sont fusionnes par Tas_concatener a la fin.
+ *
+ * \param valeurs Les valeurs a trier.
+ * \param n Le nombre de valeurs.
+ * \param k Nombre de valeurs a garder.
+ * \param cmp L'ordre des valeurs.
+ * \param nb_fils Nombre de fils d'execution (le fil appelant compte pour un).
+ * \return Un tas borne qui contient les k plus grandes valeurs.
+ */
+Heap Tas_selectionner(void** valeurs, size_t n, size_t k, Tas_comparateur cmp, unsigned nb_fils);
+
+
 /**
  * \fn Heap concatener_heap(Heap h, const Heap h2)
  * \brief Fonction qui concatener deux tas.
  * 
+ * Si h est borne, les valeurs de h2 lui sont proposees une a une et
+ * celles qui sortent sont perdues (h2 n'est pas modifie).
+ * 
  * \param h Le tas auqeuel on ajoute h2.
  * \param h2 Le tas qui sera ajoute a h.
  * \return h La concatenation de h et h2 */
 Heap Tas_concatener(Heap h, const Heap h2);
 
 
+/**
+ * \fn void Tas_vider(Heap h)
+ * \brief Enleve toutes les valeurs du tas en gardant son tableau.
+ *
+ * La capacite ne change pas : remplir de nouveau le tas jusqu'a la meme
+ * taille n'alloue rien.
+ *
+ * \param h Le tas a vider.
+ */
+void Tas_vider(Heap h);
+
+
 /**
  * \fn int estVide_heap(Heap h)
  * \brief Fonction dit si le tas est vide ou non.
  * 
+ * Un tas qui ne contient que des cases marquees supprimees est vide.
+ *
  * \param h Le tas dont on va verifier s'il est vide.
  * \return 1 Si le tas est vide.
  * \return 0 Sinon
@@ -113,13 +375,297 @@ int Tas_estVide(Heap h);
  * \fn Heap enlever_valeur(size_t i, Heap h)
  * \brief Fonction qui enleve l'element qui se trouve a la position i dans le tas
  *
- * \param i L'indice de la valeur a supprimer.
+ * L'element est enleve sur place : en O(log n) si le tas a un comparateur
+ * (la derniere case prend sa place puis est tamisee), sinon les cases
+ * suivantes sont decalees pour garder l'ordre du tableau.
+ *
+ * \param i L'indice de la valeur a supprimer (inferieur a Tas_taille(h)).
  * \param h Le tas ou l'on va supprimer la valeur.
- * \return le tas h avec la valeur enleve si elle est bien inferieur la taille du tas
+ * \return le tas h avec la valeur enleve
  */
 Heap Tas_enlever_valeur(size_t i, Heap h);
 
 
+/**
+ * \fn void Tas_marquer_mort(Heap h, size_t i)
+ * \brief Suppression paresseuse : marque la case i comme supprimee en O(1).
+ *
+ * La case reste dans le tableau et garde sa place dans l'ordre du tas ;
+ * Tas_extraire, Tas_sommet et les fonctions d'ecriture l'ignorent. Quand la
+ * proportion de cases mortes depasse le seuil du tas, Tas_compacter est
+ * appele : le cout est amorti sur les marquages.
+ * La valeur sert encore aux comparaisons tant que la case n'est pas sortie
+ * du tas : un pointeur ne doit pas etre libere avant Tas_compacter.
+ *
+ * \param h Le tas.
+ * \param i L'indice de la case (inferieur a Tas_taille(h)).
+ */
+void Tas_marquer_mort(Heap h, size_t i);
+
+
+/**
+ * \fn void Tas_compacter(Heap h)
+ * \brief Enleve d'un coup toutes les cases marquees supprimees, en O(n).
+ *
+ * Les cases vivantes gardent leur ordre relatif puis le tas est reorganise
+ * avec Tas_tasser.
+ *
+ * \param h Le tas.
+ */
+void Tas_compacter(Heap h);
+
+
+/**
+ * \fn void Tas_fixer_seuil(Heap h, double seuil)
+ * \brief Fixe la proportion de cases mortes qui declenche un compactage.
+ *
+ * \param h Le tas.
+ * \param seuil Entre 0 (compacter a chaque marquage) et 1 (ne compacter que
+ * quand toutes les cases sont mortes). TAS_SEUIL_DEFAUT a la creation.
+ */
+void Tas_fixer_seuil(Heap h, double seuil);
+
+
+/**
+ * \fn size_t Tas_nb_morts(const Heap h)
+ * \brief Retourne le nombre de cases marquees supprimees et pas encore compactees.
+ */
+size_t Tas_nb_morts(const Heap h);
+
+
+/**
+ * \fn Heap Tas_ouvrirPersistant(const char* chemin, size_t nb)
+ * \brief Ouvre (ou cree) un tas persistant dont le tableau est projete dans un fichier.
+ *
+ * L'ouverture ne relit rien : le fichier est projete tel quel (O(1)).
+ * L'agrandissement se fait par ftruncate puis nouvelle projection.
+ * Les valeurs sont stockees en ligne, il faut donc y mettre des scalaires
+ * (par exemple un entier converti avec (void*)(intptr_t)) et non des pointeurs.
+ *
+ * \param chemin Le fichier qui contient le tas.
+ * \param nb Capacite initiale si le fichier est cree.
+ * \return Le tas, ou NULL si le fichier est illisible ou n'est pas un tas.
+ */
+Heap Tas_ouvrirPersistant(const char* chemin, size_t nb);
+
+
+/**
+ * \fn int Tas_synchroniser(Heap h)
+ * \brief Point de reprise : force l'ecriture du tas persistant sur le disque (msync).
+ *
+ * Les marques de suppression ne sont gardees qu'en memoire : le tas est
+ * compacte avant l'ecriture (de meme par Tas_detruire).
+ *
+ * \param h Le tas persistant.
+ * \return 0 en cas de succes, -1 sinon (ou si le tas n'est pas persistant).
+ */
+int Tas_synchroniser(Heap h);
+
+
+/**
+ * \fn void Tas_fixer_comparateur(Heap h, Tas_comparateur cmp)
+ * \brief Fixe l'ordre du tas.
+ *
+ * Ne reorganise pas le tableau (O(1)) : appeler Tas_tasser si le contenu
+ * n'est pas deja un tas pour cmp (par exemple un tas persistant rouvert).
+ *
+ * \param h Le tas.
+ * \param cmp La fonction de comparaison, NULL pour revenir a un tableau non ordonne.
+ */
+void Tas_fixer_comparateur(Heap h, Tas_comparateur cmp);
+
+
+/**
+ * \fn void Tas_tasser(Heap h)
+ * \brief Reorganise tout le tableau en tas en O(n) (tamisage de bas en haut).
+ *
+ * \param h Le tas a reorganiser.
+ */
+void Tas_tasser(Heap h);
+
+
+/**
+ * \fn void* Tas_sommet(Heap h)
+ * \brief Retourne la valeur qui sortira en premier, sans l'enlever.
+ *
+ * Les cases marquees supprimees (Tas_marquer_mort) arrivees au sommet sont
+ * d'abord enlevees : consulter le sommet peut donc changer Tas_taille et
+ * Tas_nb_morts, et ecrit dans le fichier d'un tas persistant.
+ *
+ * \param h Le tas (non vide).
+ * \return La valeur au sommet du tas.
+ */
+void* Tas_sommet(Heap h);
+
+
+/**
+ * \fn void* Tas_extraire(Heap h)
+ * \brief Enleve et retourne la valeur au sommet du tas en O(log n).
+ *
+ * \param h Le tas (non vide).
+ * \return La valeur qui etait au sommet.
+ */
+void* Tas_extraire(Heap h);
+
+
+/**
+ * \fn void Tas_fixer_minmax(Heap h, int actif)
+ * \brief Passe le tas en mode min-max (ou le ramene en tas simple) et le reorganise en O(n).
+ *
+ * En mode min-max, les niveaux pairs du tableau (racine comprise) sont
+ * ordonnes comme un tas min et les niveaux impairs comme un tas max : le
+ * minimum est a la racine et le maximum est l'un de ses deux fils. Le meme
+ * tableau sert donc les deux bouts, sans copie du tas.
+ * Tas_sommet, Tas_extraire et les autres fonctions restent valables.
+ *
+ * \param h Le tas (qui doit avoir un comparateur).
+ * \param actif 1 pour le mode min-max, 0 pour un tas simple.
+ */
+void Tas_fixer_minmax(Heap h, int actif);
+
+
+/**
+ * \fn void* Tas_min(Heap h)
+ * \brief Retourne la plus petite valeur en O(1) (comme Tas_sommet, qui peut enlever des cases mortes).
+ */
+void* Tas_min(Heap h);
+
+
+/**
+ * \fn void* Tas_max(Heap h)
+ * \brief Retourne la plus grande valeur d'un tas min-max en O(1).
+ *
+ * Comme Tas_sommet, enleve d'abord les cases mortes arrivees a la place du maximum.
+ *
+ * \param h Le tas (non vide, en mode min-max).
+ * \return La plus grande valeur pour le comparateur du tas.
+ */
+void* Tas_max(Heap h);
+
+
+/**
+ * \fn void* Tas_extraire_min(Heap h)
+ * \brief Enleve et retourne la plus petite valeur en O(log n) (comme Tas_extraire).
+ */
+void* Tas_extraire_min(Heap h);
+
+
+/**
+ * \fn void* Tas_extraire_max(Heap h)
+ * \brief Enleve et retourne la plus grande valeur d'un tas min-max en O(log n).
+ *
+ * \param h Le tas (non vide, en mode min-max).
+ * \return La valeur qui etait la plus grande.
+ */
+void* Tas_extraire_max(Heap h);
+
+
+/**
+ * \fn size_t Tas_trouver(const Heap h, const void* val)
+ * \brief Cherche une case qui contient exactement val (meme mot machine).
+ *
+ * Convient aux scalaires stockes dans les cases et a la recherche d'un
+ * pointeur precis. Le tableau est parcouru par 4 cases a la fois avec AVX2
+ * quand le processeur le permet. Les cases marquees supprimees sont ignorees.
+ *
+ * \param h Le tas.
+ * \param val La valeur cherchee.
+ * \return L'indice de la premiere case trouvee (utilisable par
+ * Tas_enlever_valeur ou Tas_marquer_mort), TAS_ABSENT sinon.
+ */
+size_t Tas_trouver(const Heap h, const void* val);
+
+
+/**
+ * \fn size_t Tas_compter_egaux(const Heap h, const void* val)
+ * \brief Compte les cases qui contiennent exactement val (chemin AVX2 comme Tas_trouver).
+ */
+size_t Tas_compter_egaux(const Heap h, const void* val);
+
+
+/**
+ * \fn size_t Tas_supprimer_egaux(Heap h, const void* val)
+ * \brief Enleve toutes les cases qui contiennent exactement val.
+ *
+ * Les cases restantes sont tassees sur place par morceaux (chemin AVX2 pour
+ * trouver les cases a enlever), puis le tas est reorganise une seule fois
+ * en O(n) au lieu d'une reorganisation par case enlevee.
+ *
+ * \param h Le tas.
+ * \param val La valeur a enlever.
+ * \return Le nombre de cases enlevees.
+ */
+size_t Tas_supprimer_egaux(Heap h, const void* val);
+
+
+/**
+ * \fn size_t Tas_compter_si(const Heap h, Tas_predicat p, void* contexte)
+ * \brief Compte les valeurs pour lesquelles p est vrai.
+ */
+size_t Tas_compter_si(const Heap h, Tas_predicat p, void* contexte);
+
+
+/**
+ * \fn size_t Tas_supprimer_si(Heap h, Tas_predicat p, void* contexte)
+ * \brief Enleve toutes les valeurs pour lesquelles p est vrai.
+ *
+ * Un seul passage tasse les valeurs gardees (dans leur ordre), puis le tas
+ * est reorganise une seule fois en O(n). Les cases marquees supprimees
+ * sont enlevees au passage.
+ *
+ * \param h Le tas.
+ * \param p Le predicat.
+ * \param contexte Passe a p.
+ * \return Le nombre de valeurs enlevees.
+ */
+size_t Tas_supprimer_si(Heap h, Tas_predicat p, void* contexte);
+
+
+/**
+ * \fn void Tas_pour_chaque(const Heap h, Tas_action f, void* contexte)
+ * \brief Appelle f sur chaque valeur, dans l'ordre du tableau.
+ *
+ * f ne doit pas modifier le tas.
+ */
+void Tas_pour_chaque(const Heap h, Tas_action f, void* contexte);
+
+
+/**
+ * \fn int Tas_comparer_entiers(const void* a, const void* b)
+ * \brief Comparateur pour des entiers stockes directement dans les cases ((void*)(intptr_t)x).
+ */
+int Tas_comparer_entiers(const void* a, const void* b);
+
+
+/**
+ * \fn int Tas_ecrire(const Heap h, int fd)
+ * \brief Ecrit le tas au format binaire sur un descripteur de fichier.
+ *
+ * Le format est un en-tete (signature "BSDT", version, taille d'un
+ * enregistrement, nombre d'elements) suivi des cases du tableau, ecrites
+ * telles quelles par gros blocs. Les entiers sont dans l'ordre des octets
+ * de la machine.
+ *
+ * \param h Le tas a ecrire.
+ * \param fd Le descripteur ou ecrire.
+ * \return 0 en cas de succes, -1 en cas d'erreur d'ecriture.
+ */
+int Tas_ecrire(const Heap h, int fd);
+
+
+/**
+ * \fn Heap Tas_lire(int fd, Tas_comparateur cmp)
+ * \brief Relit un tas ecrit par Tas_ecrire.
+ *
+ * Le tableau est lu d'un bloc puis reorganise en O(n) avec Tas_tasser.
+ *
+ * \param fd Le descripteur ou lire.
+ * \param cmp L'ordre du tas relu (peut etre NULL).
+ * \return Le tas relu, ou NULL si le flux est invalide ou si son tableau ne tient pas en memoire.
+ */
+Heap Tas_lire(int fd, Tas_comparateur cmp);
+
+
 
 #endif
 
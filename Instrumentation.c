@@ -0,0 +1,59 @@
+/**
+ * \file Instrumentation.c
+ * \author Zevio.S et Benharchache.S
+ * \brief Fichier source des compteurs d'instrumentation
+ * \date 18 decembre 2014
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <time.h>
+
+#include "Instrumentation.h"
+
+#ifdef BIBLISD_INSTRUMENTATION
+
+struct instr_compteurs instr_compteurs_globaux[INSTR_NB_CONTENEURS];
+
+uint64_t Instr_horloge(void){
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec*1000000000u + (uint64_t)t.tv_nsec;
+}
+
+void Instr_latence(enum instr_conteneur c, enum instr_operation op, uint64_t debut){
+	uint64_t duree = Instr_horloge() - debut;
+	// Seau = nombre de bits significatifs de la duree
+	unsigned seau = (duree == 0) ? 0 : 64 - __builtin_clzll(duree);
+	if(seau >= INSTR_NB_SEAUX)
+		seau = INSTR_NB_SEAUX-1;
+	__atomic_fetch_add(&instr_compteurs_globaux[c].operations[op], 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&instr_compteurs_globaux[c].latence[op][seau], 1, __ATOMIC_RELAXED);
+}
+
+void Instr_instantane(enum instr_conteneur c, struct instr_compteurs* dest){
+	// Copie champ par champ pour ne pas lire un compteur a moitie ecrit
+	const uint64_t* src = (const uint64_t*)&instr_compteurs_globaux[c];
+	uint64_t* dst = (uint64_t*)dest;
+	for(size_t i = 0; i < sizeof(struct instr_compteurs)/sizeof(uint64_t); i++)
+		dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+}
+
+void Instr_reinitialiser(void){
+	uint64_t* p = (uint64_t*)instr_compteurs_globaux;
+	for(size_t i = 0; i < INSTR_NB_CONTENEURS*(sizeof(struct instr_compteurs)/sizeof(uint64_t)); i++)
+		__atomic_store_n(&p[i], 0, __ATOMIC_RELAXED);
+}
+
+#else
+
+void Instr_instantane(enum instr_conteneur c, struct instr_compteurs* dest){
+	(void)c;
+	memset(dest, 0, sizeof(*dest));
+}
+
+void Instr_reinitialiser(void){
+}
+
+#endif
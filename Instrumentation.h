@@ -0,0 +1,112 @@
+/**
+ * \file Instrumentation.h
+ * \author Zevio.S et Benharchache.S
+ * \brief Compteurs et histogrammes de latence des operations sur les conteneurs
+ * \date 18 decembre 2014
+ *
+ * La couche n'existe que si BIBLISD_INSTRUMENTATION est defini a la compilation
+ * (make INSTRUMENTATION=1). Sinon toutes les macros INSTR_* sont vides et le
+ * code des conteneurs est identique a celui compile sans ce fichier.
+ */
+
+#ifndef SOFIEN_STELLA__INSTRUMENTATION_H__
+#define SOFIEN_STELLA__INSTRUMENTATION_H__
+
+#include <stdint.h>
+
+
+/**
+ * \brief Nombre de seaux des histogrammes : le seau k compte les operations
+ * qui ont dure entre 2^(k-1) et 2^k nanosecondes.
+ */
+#define INSTR_NB_SEAUX 32
+
+/**
+ * \enum instr_conteneur
+ * \brief Les conteneurs instrumentes.
+ */
+enum instr_conteneur{
+	INSTR_TAS,
+	INSTR_LISTE,
+	INSTR_NB_CONTENEURS
+};
+
+/**
+ * \enum instr_operation
+ * \brief Les operations dont on compte le nombre et la latence.
+ */
+enum instr_operation{
+	INSTR_AJOUT,		/*!< Tas_ajouter_valeur */
+	INSTR_EXTRACTION,	/*!< Tas_extraire */
+	INSTR_SUPPRESSION,	/*!< Tas_enlever_valeur, ll_remove_at */
+	INSTR_CONCATENATION,	/*!< Tas_concatener */
+	INSTR_INSERTION,	/*!< ll_insert (et donc ll_push_front, ll_push_back) */
+	INSTR_ACCES,		/*!< ll_get */
+	INSTR_RECHERCHE,	/*!< ll_contains */
+	INSTR_COPIE,		/*!< Tas_creerTasParCopie, ll_clone */
+	INSTR_NB_OPERATIONS
+};
+
+/**
+ * \struct instr_compteurs
+ * \brief Les compteurs d'un conteneur.
+ */
+struct instr_compteurs{
+	uint64_t operations[INSTR_NB_OPERATIONS];	/*!< Nombre d'appels par operation. */
+	uint64_t allocations;		/*!< Appels a malloc. */
+	uint64_t reallocations;		/*!< Appels a realloc (ou reprojections). */
+	uint64_t octets_deplaces;	/*!< Octets recopies d'une zone memoire a une autre. */
+	uint64_t pas_parcours;		/*!< Noeuds visites en parcourant une liste. */
+	uint64_t comparaisons;		/*!< Appels au comparateur ou a memcmp. */
+	uint64_t latence[INSTR_NB_OPERATIONS][INSTR_NB_SEAUX];	/*!< Histogrammes de latence. */
+};
+
+
+/**
+ * \fn void Instr_instantane(enum instr_conteneur c, struct instr_compteurs* dest)
+ * \brief Copie les compteurs actuels d'un conteneur (tous a zero sans instrumentation).
+ *
+ * \param c Le conteneur.
+ * \param dest La copie.
+ */
+void Instr_instantane(enum instr_conteneur c, struct instr_compteurs* dest);
+
+
+/**
+ * \fn void Instr_reinitialiser(void)
+ * \brief Remet tous les compteurs a zero.
+ */
+void Instr_reinitialiser(void);
+
+
+#ifdef BIBLISD_INSTRUMENTATION
+
+extern struct instr_compteurs instr_compteurs_globaux[INSTR_NB_CONTENEURS];
+
+/**
+ * \fn uint64_t Instr_horloge(void)
+ * \brief Horloge monotone en nanosecondes.
+ */
+uint64_t Instr_horloge(void);
+
+/**
+ * \fn void Instr_latence(enum instr_conteneur c, enum instr_operation op, uint64_t debut)
+ * \brief Compte une operation et range sa duree dans l'histogramme.
+ */
+void Instr_latence(enum instr_conteneur c, enum instr_operation op, uint64_t debut);
+
+#define INSTR_COMPTER(c, champ, n) \
+	((void)__atomic_fetch_add(&instr_compteurs_globaux[c].champ, (uint64_t)(n), __ATOMIC_RELAXED))
+#define INSTR_DEBUT(var) uint64_t var = Instr_horloge()
+#define INSTR_FIN(c, op, var) Instr_latence(c, op, var)
+
+#else
+
+#define INSTR_COMPTER(c, champ, n) ((void)sizeof(n))
+#define INSTR_DEBUT(var)
+#define INSTR_FIN(c, op, var) ((void)0)
+
+#endif
+
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * \file Recyclage.c
+ * \author Zevio.S et Benharchache.S
+ * \brief Fichier source du cache de blocs par fil
+ * \date 18 decembre 2014
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "Recyclage.h"
+
+#ifndef BIBLISD_SANS_RECYCLAGE
+
+/*
+ * Cache d'un fil : une pile de blocs libres par classe, chainee par le
+ * premier mot de chaque bloc.
+ */
+struct recyclage_cache{
+	void* libres[RECYCLAGE_NB_CLASSES];
+	size_t nb[RECYCLAGE_NB_CLASSES];
+	int enregistre;		// 1 quand la fin du fil videra le cache
+	struct recyclage_stats stats;
+};
+
+static __thread struct recyclage_cache cache;
+static pthread_key_t recyclage_cle;
+static pthread_once_t recyclage_cle_creee = PTHREAD_ONCE_INIT;
+
+// Classe de taille : 0 pour RECYCLAGE_MIN octets, k pour RECYCLAGE_MIN << k
+static unsigned Recyclage_classe(size_t taille){
+	if(taille <= RECYCLAGE_MIN)
+		return 0;
+	return (unsigned)(64 - __builtin_clzll((unsigned long long)(taille-1))) - 4;
+}
+
+static void Recyclage_fin_du_fil(void* arg){
+	(void)arg;
+	Recyclage_vider();
+	cache.enregistre = 0; // un bloc rendu par un destructeur suivant reenregistre le cache
+}
+
+static void Recyclage_creer_cle(void){
+	pthread_key_create(&recyclage_cle, Recyclage_fin_du_fil);
+}
+
+size_t Recyclage_taille(size_t taille){
+	if(taille > RECYCLAGE_MAX)
+		return taille;
+	return (size_t)RECYCLAGE_MIN << Recyclage_classe(taille);
+}
+
+void* Recyclage_prendre(size_t taille){
+	if(taille > RECYCLAGE_MAX)
+		return malloc(taille);
+	unsigned c = Recyclage_classe(taille);
+	cache.stats.prises++;
+	void* p = cache.libres[c];
+	if(p == NULL)
+		return malloc((size_t)RECYCLAGE_MIN << c);
+	memcpy(&cache.libres[c], p, sizeof(void*));
+	cache.nb[c]--;
+	cache.stats.reutilisees++;
+	return p;
+}
+
+void Recyclage_rendre(void* p, size_t taille){
+	if(p == NULL)
+		return;
+	if(taille > RECYCLAGE_MAX){
+		free(p);
+		return;
+	}
+	unsigned c = Recyclage_classe(taille);
+	cache.stats.rendues++;
+	if(cache.nb[c] >= RECYCLAGE_OCTETS_PAR_CLASSE / ((size_t)RECYCLAGE_MIN << c)){
+		cache.stats.liberees++;
+		free(p);
+		return;
+	}
+	if(!cache.enregistre){
+		pthread_once(&recyclage_cle_creee, Recyclage_creer_cle);
+		pthread_setspecific(recyclage_cle, &cache);
+		cache.enregistre = 1;
+	}
+	memcpy(p, &cache.libres[c], sizeof(void*));
+	cache.libres[c] = p;
+	cache.nb[c]++;
+}
+
+void Recyclage_vider(void){
+	for(unsigned c = 0; c < RECYCLAGE_NB_CLASSES; c++){
+		while(cache.libres[c] != NULL){
+			void* p = cache.libres[c];
+			memcpy(&cache.libres[c], p, sizeof(void*));
+			free(p);
+		}
+		cache.nb[c] = 0;
+	}
+}
+
+void Recyclage_statistiques(struct recyclage_stats* stats){
+	*stats = cache.stats;
+}
+
+#else
+
+size_t Recyclage_taille(size_t taille){
+	return taille;
+}
+
+void* Recyclage_prendre(size_t taille){
+	return malloc(taille);
+}
+
+void Recyclage_rendre(void* p, size_t taille){
+	(void)taille;
+	free(p);
+}
+
+void Recyclage_vider(void){
+}
+
+void Recyclage_statistiques(struct recyclage_stats* stats){
+	memset(stats, 0, sizeof(*stats));
+}
+
+#endif
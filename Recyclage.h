@@ -0,0 +1,93 @@
+/**
+ * \file Recyclage.h
+ * \author Zevio.S et Benharchache.S
+ * \brief Cache par fil des blocs memoire des conteneurs
+ * \date 18 decembre 2014
+ *
+ * Les structures des tas, leurs tableaux et les blocs de noeuds des listes
+ * sont pris et rendus ici plutot qu'a malloc et free. Un bloc rendu reste dans
+ * le cache du fil qui l'a rendu et sert au prochain bloc de la meme classe de
+ * taille pris par ce fil : un programme qui cree et detruit sans cesse les
+ * memes conteneurs n'appelle plus malloc une fois le cache rempli.
+ *
+ * Les tailles sont arrondies a la puissance de deux superieure, de
+ * RECYCLAGE_MIN a RECYCLAGE_MAX octets. Au-dela, prendre et rendre sont
+ * malloc et free. Chaque classe garde au plus RECYCLAGE_OCTETS_PAR_CLASSE
+ * octets par fil ; le cache d'un fil est libere a la fin du fil.
+ *
+ * Un bloc peut etre rendu par un autre fil que celui qui l'a pris, et passe
+ * alors dans le cache de cet autre fil. Un bloc de Recyclage_prendre peut
+ * aussi etre passe a free ou realloc.
+ *
+ * Compile avec BIBLISD_SANS_RECYCLAGE, le cache n'existe pas : les outils
+ * comme AddressSanitizer voient alors chaque bloc libere.
+ */
+
+#ifndef SOFIEN_STELLA__RECYCLAGE_H__
+#define SOFIEN_STELLA__RECYCLAGE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define RECYCLAGE_MIN 16
+#define RECYCLAGE_MAX 65536
+#define RECYCLAGE_NB_CLASSES 13	/*!< De RECYCLAGE_MIN a RECYCLAGE_MAX. */
+#define RECYCLAGE_OCTETS_PAR_CLASSE (512*1024)
+
+/**
+ * \struct recyclage_stats
+ * \brief Compteurs du cache d'un fil (blocs d'au plus RECYCLAGE_MAX octets).
+ */
+struct recyclage_stats{
+	uint64_t prises;	/*!< Appels a Recyclage_prendre. */
+	uint64_t reutilisees;	/*!< Prises servies par le cache, sans malloc. */
+	uint64_t rendues;	/*!< Appels a Recyclage_rendre. */
+	uint64_t liberees;	/*!< Blocs rendus a free parce que leur classe etait pleine. */
+};
+
+
+/**
+ * \fn size_t Recyclage_taille(size_t taille)
+ * \brief Taille utilisable d'un bloc de Recyclage_prendre(taille).
+ *
+ * Un conteneur peut demander cette taille plutot que taille, pour utiliser
+ * tout le bloc.
+ */
+size_t Recyclage_taille(size_t taille);
+
+
+/**
+ * \fn void* Recyclage_prendre(size_t taille)
+ * \brief Retourne un bloc d'au moins taille octets, pris dans le cache du fil si possible.
+ *
+ * \return Le bloc, ou NULL si malloc echoue.
+ */
+void* Recyclage_prendre(size_t taille);
+
+
+/**
+ * \fn void Recyclage_rendre(void* p, size_t taille)
+ * \brief Rend un bloc au cache du fil appelant.
+ *
+ * \param p Un bloc de Recyclage_prendre, ou NULL.
+ * \param taille La taille demandee a Recyclage_prendre (ou une taille de meme Recyclage_taille).
+ */
+void Recyclage_rendre(void* p, size_t taille);
+
+
+/**
+ * \fn void Recyclage_vider(void)
+ * \brief Libere tous les blocs du cache du fil appelant.
+ */
+void Recyclage_vider(void);
+
+
+/**
+ * \fn void Recyclage_statistiques(struct recyclage_stats* stats)
+ * \brief Copie les compteurs du fil appelant (tous a zero avec BIBLISD_SANS_RECYCLAGE).
+ */
+void Recyclage_statistiques(struct recyclage_stats* stats);
+
+
+#endif
@@ -0,0 +1,305 @@
+/**
+ * \file TasExterne.c
+ * \author Zevio.S et Benharchache.S
+ * \brief Fichier source de la file de priorite en memoire externe
+ * \date 18 decembre 2014
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "TasExterne.h"
+
+// Bloc minimal, pour que les lectures restent sequentielles meme avec un petit budget
+#define TAS_EXTERNE_BLOC_MIN 64
+
+/*
+ * Une serie triee dans un fichier temporaire, lue bloc par bloc.
+ */
+struct tas_serie{
+	FILE* f;
+	uint64_t restants;	// valeurs du fichier pas encore lues
+	unsigned niveau;	// 0 pour un vidage, k+1 pour la fusion de series de niveau k
+	size_t pos;		// prochaine valeur du bloc
+	size_t fin;		// nombre de valeurs lues dans le bloc
+	void* bloc[];
+};
+
+static struct tas_serie* TasExterne_nouvelle_serie(TasExterne t){
+	struct tas_serie* s = malloc(sizeof(struct tas_serie) + t->bloc*sizeof(void*));
+	if(s == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir de la serie");
+		exit(1);
+	}
+	if((s->f = tmpfile()) == NULL){
+		perror("tmpfile");
+		exit(1);
+	}
+	// Les blocs sont deja gros : pas de second tampon dans stdio
+	setvbuf(s->f, NULL, _IONBF, 0);
+	s->restants = 0;
+	s->niveau = 0;
+	s->pos = 0;
+	s->fin = 0;
+	return s;
+}
+
+static void TasExterne_ecrire_bloc(TasExterne t, struct tas_serie* s, size_t n){
+	if(n > 0 && fwrite(s->bloc, sizeof(void*), n, s->f) != n){
+		perror("ecriture d'une serie");
+		exit(1);
+	}
+	s->restants += n;
+	t->ecritures += n;
+}
+
+// Lit le bloc suivant de la serie, retourne 0 si elle est finie
+static int TasExterne_recharger(TasExterne t, struct tas_serie* s){
+	size_t n = (s->restants < t->bloc) ? (size_t)s->restants : t->bloc;
+	if(n == 0)
+		return 0;
+	if(fread(s->bloc, sizeof(void*), n, s->f) != n){
+		perror("lecture d'une serie");
+		exit(1);
+	}
+	s->restants -= n;
+	s->pos = 0;
+	s->fin = n;
+	return 1;
+}
+
+// 1 si la serie a doit etre lue avant la serie b
+static int TasExterne_avant(TasExterne t, size_t a, size_t b){
+	struct tas_serie* x = t->series[a];
+	struct tas_serie* y = t->series[b];
+	return t->insertion.compare(x->bloc[x->pos], y->bloc[y->pos]) < 0;
+}
+
+static void TasExterne_echanger(TasExterne t, size_t a, size_t b){
+	struct tas_serie* s = t->series[a];
+	t->series[a] = t->series[b];
+	t->series[b] = s;
+}
+
+static void TasExterne_descendre(TasExterne t, size_t i){
+	size_t fils;
+	while((fils = 2*i+1) < t->nb_series){
+		if(fils+1 < t->nb_series && TasExterne_avant(t, fils+1, fils))
+			fils++;
+		if(!TasExterne_avant(t, fils, i))
+			break;
+		TasExterne_echanger(t, i, fils);
+		i = fils;
+	}
+}
+
+static void TasExterne_remonter(TasExterne t, size_t i){
+	while(i > 0 && TasExterne_avant(t, i, (i-1)/2)){
+		TasExterne_echanger(t, i, (i-1)/2);
+		i = (i-1)/2;
+	}
+}
+
+// Ajoute une serie ecrite au tas des series
+static void TasExterne_ajouter_serie(TasExterne t, struct tas_serie* s){
+	rewind(s->f);
+	if(!TasExterne_recharger(t, s)){
+		fclose(s->f);
+		free(s);
+		return;
+	}
+	if(t->nb_series == t->max_series){
+		struct tas_serie** tmp = realloc(t->series, 2*t->max_series*sizeof(struct tas_serie*));
+		if(tmp == NULL){
+			fprintf(stderr, "errueut lors de l'allocation de memoir des series");
+			exit(1);
+		}
+		t->series = tmp;
+		t->max_series *= 2;
+	}
+	t->series[t->nb_series++] = s;
+	TasExterne_remonter(t, t->nb_series-1);
+}
+
+// Enleve et retourne la premiere valeur de la serie au sommet
+static void* TasExterne_avancer(TasExterne t){
+	struct tas_serie* s = t->series[0];
+	void* val = s->bloc[s->pos++];
+
+	if(s->pos == s->fin && !TasExterne_recharger(t, s)){
+		fclose(s->f);
+		free(s);
+		t->series[0] = t->series[--t->nb_series];
+	}
+	TasExterne_descendre(t, 0);
+	return val;
+}
+
+// Refait le tas des series apres un changement de t->series
+static void TasExterne_tasser(TasExterne t){
+	for(size_t i = t->nb_series/2; i-- > 0; )
+		TasExterne_descendre(t, i);
+}
+
+// Fusionne les series du niveau donne en une serie du niveau suivant.
+// Les autres series ne sont pas relues : chaque valeur n'est recopiee
+// qu'une fois par niveau, soit O(log(N/M)) fois en tout.
+static void TasExterne_fusionner(TasExterne t, unsigned niveau){
+	struct tas_serie** toutes = t->series;
+	size_t nb = t->nb_series, autres = 0;
+
+	// Les series du niveau passent a la fin du tableau, ou elles forment leur propre tas
+	for(size_t i = 0; i < nb; i++){
+		if(toutes[i]->niveau != niveau){
+			struct tas_serie* s = toutes[i];
+			toutes[i] = toutes[autres];
+			toutes[autres++] = s;
+		}
+	}
+	t->series = toutes + autres;
+	t->nb_series = nb - autres;
+	TasExterne_tasser(t);
+
+	struct tas_serie* sortie = TasExterne_nouvelle_serie(t);
+	size_t n = 0;
+
+	sortie->niveau = niveau + 1;
+	while(t->nb_series > 0){
+		sortie->bloc[n++] = TasExterne_avancer(t);
+		if(n == t->bloc){
+			TasExterne_ecrire_bloc(t, sortie, n);
+			n = 0;
+		}
+	}
+	TasExterne_ecrire_bloc(t, sortie, n);
+
+	t->series = toutes;
+	t->nb_series = autres;
+	TasExterne_tasser(t);
+	TasExterne_ajouter_serie(t, sortie);
+}
+
+// Nombre de series du niveau donne
+static size_t TasExterne_compter(TasExterne t, unsigned niveau){
+	size_t n = 0;
+	for(size_t i = 0; i < t->nb_series; i++)
+		n += t->series[i]->niveau == niveau;
+	return n;
+}
+
+// Vide le tas en memoire dans une nouvelle serie triee, puis fusionne les
+// niveaux pleins, du plus bas au plus haut
+static void TasExterne_vider(TasExterne t){
+	struct tas_serie* s = TasExterne_nouvelle_serie(t);
+	size_t n = 0;
+
+	// Le bloc de la serie sert de tampon d'ecriture
+	while(!Tas_estVide(&t->insertion)){
+		s->bloc[n++] = Tas_extraire(&t->insertion);
+		if(n == t->bloc){
+			TasExterne_ecrire_bloc(t, s, n);
+			n = 0;
+		}
+	}
+	TasExterne_ecrire_bloc(t, s, n);
+	TasExterne_ajouter_serie(t, s);
+
+	for(unsigned niveau = 0; TasExterne_compter(t, niveau) >= TAS_EXTERNE_SERIES; niveau++)
+		TasExterne_fusionner(t, niveau);
+}
+
+TasExterne TasExterne_creer(Tas_comparateur cmp, size_t memoire){
+	TasExterne t;
+	size_t moitie = memoire/2/sizeof(void*);
+
+	if(cmp == NULL){
+		fprintf(stderr, "une file externe demande un comparateur\n");
+		exit(1);
+	}
+	if((t = malloc(sizeof(struct tas_externe))) == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir de la structure");
+		exit(1);
+	}
+	Tas_initialiser(&t->insertion, 0);
+	Tas_fixer_comparateur(&t->insertion, cmp);
+
+	// Une puissance de deux : le tableau du tas double jusqu'a elle sans la depasser
+	t->capacite = 2*TAS_PETIT;
+	while(t->capacite*2 <= moitie)
+		t->capacite *= 2;
+
+	// Pendant une fusion, chaque serie et la sortie ont leur bloc
+	t->bloc = moitie / (TAS_EXTERNE_SERIES+1);
+	if(t->bloc < TAS_EXTERNE_BLOC_MIN)
+		t->bloc = TAS_EXTERNE_BLOC_MIN;
+	if(t->bloc > TAS_EXTERNE_BLOC)
+		t->bloc = TAS_EXTERNE_BLOC;
+
+	t->max_series = TAS_EXTERNE_SERIES;
+	if((t->series = malloc(t->max_series*sizeof(struct tas_serie*))) == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir des series");
+		exit(1);
+	}
+	t->nb_series = 0;
+	t->taille = 0;
+	t->ecritures = 0;
+	return t;
+}
+
+TasExterne TasExterne_detruire(TasExterne t){
+	if(t != NULL){
+		for(size_t i = 0; i < t->nb_series; i++){
+			fclose(t->series[i]->f);
+			free(t->series[i]);
+		}
+		free(t->series);
+		Tas_finaliser(&t->insertion);
+		free(t);
+	}
+	return NULL;
+}
+
+void TasExterne_ajouter(TasExterne t, void* val){
+	if(Tas_taille(&t->insertion) == t->capacite)
+		TasExterne_vider(t);
+	Tas_ajouter_valeur(&t->insertion, val);
+	t->taille++;
+}
+
+// 1 si la plus petite valeur est au debut d'une serie, 0 si elle est en memoire
+static int TasExterne_depuis_serie(TasExterne t){
+	if(t->taille == 0){
+		fprintf(stderr, "la file est vide\n");
+		exit(1);
+	}
+	if(t->nb_series == 0)
+		return 0;
+	if(Tas_estVide(&t->insertion))
+		return 1;
+	struct tas_serie* s = t->series[0];
+	return t->insertion.compare(s->bloc[s->pos], Tas_sommet(&t->insertion)) < 0;
+}
+
+void* TasExterne_sommet(TasExterne t){
+	if(TasExterne_depuis_serie(t))
+		return t->series[0]->bloc[t->series[0]->pos];
+	return Tas_sommet(&t->insertion);
+}
+
+void* TasExterne_extraire(TasExterne t){
+	void* val = TasExterne_depuis_serie(t) ? TasExterne_avancer(t) : Tas_extraire(&t->insertion);
+	t->taille--;
+	return val;
+}
+
+uint64_t TasExterne_taille(const TasExterne t){
+	return t->taille;
+}
+
+int TasExterne_estVide(const TasExterne t){
+	return t->taille == 0;
+}
+
+size_t TasExterne_nb_series(const TasExterne t){
+	return t->nb_series;
+}
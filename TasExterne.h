@@ -0,0 +1,134 @@
+/**
+ * \file TasExterne.h
+ * \author Zevio.S et Benharchache.S
+ * \brief File de priorite en memoire externe, pour plus de valeurs que la memoire n'en contient
+ * \date 18 decembre 2014
+ *
+ * Les ajouts vont dans un tas en memoire. Quand il atteint le budget de
+ * memoire, il est vide dans l'ordre dans un fichier temporaire (une "serie"
+ * triee), par gros blocs. L'extraction compare le sommet du tas en memoire
+ * au plus petit des debuts de serie, tenus dans un petit tas de series :
+ * chaque serie n'est relue que bloc par bloc, au fur et a mesure.
+ *
+ * Les series sont rangees par niveaux : un vidage donne une serie de
+ * niveau 0, et des que TAS_EXTERNE_SERIES series ont le meme niveau, elles
+ * sont fusionnees en une serie du niveau suivant. Une valeur n'est donc
+ * recopiee qu'une fois par niveau, soit O(log(N/M)) fois pour N valeurs et
+ * M valeurs de memoire, et non a chaque fusion.
+ *
+ * Comme pour le tas persistant, les valeurs sont ecrites telles quelles
+ * dans les fichiers : il faut y mettre des scalaires ((void*)(intptr_t)x)
+ * et non des pointeurs.
+ */
+
+#ifndef SOFIEN_STELLA__TASEXTERNE_H__
+#define SOFIEN_STELLA__TASEXTERNE_H__
+
+#include <stdint.h>
+
+#include "Heap.h"
+
+
+/**
+ * \brief Nombre maximal de valeurs d'un bloc d'entree / sortie.
+ */
+#define TAS_EXTERNE_BLOC 8192
+
+/**
+ * \brief Nombre de series d'un meme niveau qui sont fusionnees en une serie du niveau suivant.
+ */
+#define TAS_EXTERNE_SERIES 16
+
+
+struct tas_serie;
+
+/**
+ * \struct tas_externe
+ * \brief Une file de priorite en memoire externe.
+ */
+struct tas_externe{
+	struct heap_struct insertion;	/*!< Tas en memoire des valeurs pas encore videes. */
+	size_t capacite;		/*!< Taille du tas en memoire qui declenche le vidage d'une serie. */
+	size_t bloc;			/*!< Nombre de valeurs lues ou ecrites a la fois. */
+	struct tas_serie** series;	/*!< Tas des series, ordonne par leur premiere valeur. */
+	size_t nb_series;		/*!< Nombre de series sur le disque. */
+	size_t max_series;		/*!< Nombre de cases du tableau series. */
+	uint64_t taille;		/*!< Nombre total de valeurs. */
+	uint64_t ecritures;		/*!< Valeurs ecrites sur le disque depuis la creation (vidages et fusions). */
+};
+
+typedef struct tas_externe* TasExterne;
+
+
+/**
+ * \fn TasExterne TasExterne_creer(Tas_comparateur cmp, size_t memoire)
+ * \brief Cree une file de priorite en memoire externe.
+ *
+ * La moitie du budget va au tas en memoire, l'autre aux blocs de lecture
+ * des series (un bloc par serie, dimensionne pour TAS_EXTERNE_SERIES
+ * series). Chaque niveau au-dela du premier ajoute au plus
+ * TAS_EXTERNE_SERIES-1 blocs.
+ *
+ * \param cmp L'ordre des valeurs (non NULL).
+ * \param memoire Budget de memoire en octets.
+ * \return La file.
+ */
+TasExterne TasExterne_creer(Tas_comparateur cmp, size_t memoire);
+
+
+/**
+ * \fn TasExterne TasExterne_detruire(TasExterne t)
+ * \brief Detruit la file et ses fichiers temporaires.
+ *
+ * \return NULL.
+ */
+TasExterne TasExterne_detruire(TasExterne t);
+
+
+/**
+ * \fn void TasExterne_ajouter(TasExterne t, void* val)
+ * \brief Ajoute une valeur en O(log n) amorti (plus une ecriture sequentielle par vidage).
+ */
+void TasExterne_ajouter(TasExterne t, void* val);
+
+
+/**
+ * \fn void* TasExterne_sommet(TasExterne t)
+ * \brief Retourne la plus petite valeur sans l'enlever.
+ *
+ * \param t La file (non vide).
+ */
+void* TasExterne_sommet(TasExterne t);
+
+
+/**
+ * \fn void* TasExterne_extraire(TasExterne t)
+ * \brief Enleve et retourne la plus petite valeur.
+ *
+ * \param t La file (non vide).
+ */
+void* TasExterne_extraire(TasExterne t);
+
+
+/**
+ * \fn uint64_t TasExterne_taille(const TasExterne t)
+ * \brief Retourne le nombre de valeurs, en memoire et sur le disque.
+ */
+uint64_t TasExterne_taille(const TasExterne t);
+
+
+/**
+ * \fn int TasExterne_estVide(const TasExterne t)
+ * \brief Retourne 1 si la file est vide, 0 sinon.
+ */
+int TasExterne_estVide(const TasExterne t);
+
+
+/**
+ * \fn size_t TasExterne_nb_series(const TasExterne t)
+ * \brief Retourne le nombre de series actuellement sur le disque.
+ */
+size_t TasExterne_nb_series(const TasExterne t);
+
+
+#endif
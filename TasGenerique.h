@@ -0,0 +1,139 @@
+/**
+ * \file TasGenerique.h
+ * \author Zevio.S et Benharchache.S
+ * \brief Tas types engendres par macro, sans void* ni pointeur de fonction
+ * \date 18 decembre 2014
+ *
+ * DEFINE_HEAP(nom, T, cmp) definit le type nom (un tas de valeurs T rangees
+ * directement dans le tableau) et ses fonctions nom_initialiser, nom_finaliser,
+ * nom_reserver, nom_ajouter, nom_sommet, nom_extraire, nom_tasser, nom_taille
+ * et nom_estVide. Toutes sont static inline : cmp(a, b) (une macro ou une
+ * fonction visible, negatif si a sort avant b) est appele directement et peut
+ * etre integre dans les boucles de tamisage.
+ *
+ * #define PLUS_PETIT(a, b) TAS_CMP_NATUREL(a, b)
+ * DEFINE_HEAP(TasDouble, double, PLUS_PETIT)
+ *
+ * TasDouble h;
+ * TasDouble_initialiser(&h);
+ * TasDouble_ajouter(&h, 3.5);
+ * double x = TasDouble_extraire(&h);
+ * TasDouble_finaliser(&h);
+ *
+ * Le Heap de Heap.h reste l'instance a comparateur dynamique : c'est lui
+ * qui porte la persistance, la suppression paresseuse et le mode min-max.
+ */
+
+#ifndef SOFIEN_STELLA__TASGENERIQUE_H__
+#define SOFIEN_STELLA__TASGENERIQUE_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/**
+ * \brief Ordre croissant des types scalaires, utilisable comme cmp.
+ */
+#define TAS_CMP_NATUREL(a, b) (((a) > (b)) - ((a) < (b)))
+
+/**
+ * \brief Nombre de cases allouees au premier ajout.
+ */
+#define TAS_GENERIQUE_MIN 16
+
+
+#define DEFINE_HEAP(nom, T, cmp) \
+ \
+typedef struct nom{ \
+	T* cases; \
+	size_t taille; \
+	size_t capacite; \
+} nom; \
+ \
+static inline void nom##_initialiser(nom* h){ \
+	h->cases = NULL; \
+	h->taille = 0; \
+	h->capacite = 0; \
+} \
+ \
+static inline void nom##_finaliser(nom* h){ \
+	free(h->cases); \
+	nom##_initialiser(h); \
+} \
+ \
+static inline void nom##_reserver(nom* h, size_t capacite){ \
+	if(capacite <= h->capacite) \
+		return; \
+	T* tmp = realloc(h->cases, capacite*sizeof(T)); \
+	if(tmp == NULL){ \
+		fprintf(stderr, "errueut lors de l'allocation de memoir du tas"); \
+		exit(1); \
+	} \
+	h->cases = tmp; \
+	h->capacite = capacite; \
+} \
+ \
+static inline void nom##_remonter(nom* h, size_t i, T val){ \
+	while(i > 0){ \
+		size_t pere = (i-1)/2; \
+		if(cmp(val, h->cases[pere]) >= 0) \
+			break; \
+		h->cases[i] = h->cases[pere]; \
+		i = pere; \
+	} \
+	h->cases[i] = val; \
+} \
+ \
+static inline void nom##_descendre(nom* h, size_t i, T val){ \
+	size_t fils; \
+	while((fils = 2*i+1) < h->taille){ \
+		if(fils+1 < h->taille && cmp(h->cases[fils+1], h->cases[fils]) < 0) \
+			fils++; \
+		if(cmp(h->cases[fils], val) >= 0) \
+			break; \
+		h->cases[i] = h->cases[fils]; \
+		i = fils; \
+	} \
+	h->cases[i] = val; \
+} \
+ \
+static inline void nom##_ajouter(nom* h, T val){ \
+	if(h->taille == h->capacite) \
+		nom##_reserver(h, h->capacite ? 2*h->capacite : TAS_GENERIQUE_MIN); \
+	nom##_remonter(h, h->taille++, val); \
+} \
+ \
+static inline T nom##_sommet(const nom* h){ \
+	if(h->taille == 0){ \
+		fprintf(stderr, "le tas est vide\n"); \
+		exit(1); \
+	} \
+	return h->cases[0]; \
+} \
+ \
+static inline T nom##_extraire(nom* h){ \
+	T val = nom##_sommet(h); \
+	if(--h->taille > 0) \
+		nom##_descendre(h, 0, h->cases[h->taille]); \
+	return val; \
+} \
+ \
+/* Ajoute n valeurs d'un coup et retablit l'ordre en O(taille) */ \
+static inline void nom##_tasser(nom* h, const T* valeurs, size_t n){ \
+	nom##_reserver(h, h->taille+n); \
+	for(size_t i = 0; i < n; i++) \
+		h->cases[h->taille++] = valeurs[i]; \
+	for(size_t i = h->taille/2; i-- > 0; ) \
+		nom##_descendre(h, i, h->cases[i]); \
+} \
+ \
+static inline size_t nom##_taille(const nom* h){ \
+	return h->taille; \
+} \
+ \
+static inline int nom##_estVide(const nom* h){ \
+	return h->taille == 0; \
+}
+
+
+#endif
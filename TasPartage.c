@@ -0,0 +1,264 @@
+/**
+ * \file TasPartage.c
+ * \author Zevio.S et Benharchache.S
+ * \brief Fichier source de la file de priorite partagee par noeud NUMA
+ * \date 18 decembre 2014
+ */
+
+#define _GNU_SOURCE // sched_getcpu, pthread_setaffinity_np
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "TasPartage.h"
+
+// Les tranches sont alignees sur les lignes de cache : deux verrous ne partagent jamais une ligne
+#define TAS_PARTAGE_LIGNE 64
+
+/*
+ * Une tranche : un tas, son verrou et ses compteurs, proteges par le verrou.
+ */
+struct tas_tranche{
+	pthread_mutex_t verrou;
+	struct heap_struct tas;
+	unsigned noeud;
+	struct tas_partage_stats stats;
+};
+
+// Lit la liste des processeurs d'un noeud ("0-3,8-11"), retourne 0 si le noeud n'existe pas
+static int TasPartage_lire_noeud(TasPartage t, unsigned id, unsigned indice){
+	char chemin[64];
+	unsigned debut, fin;
+	FILE* f;
+
+	snprintf(chemin, sizeof(chemin), "/sys/devices/system/node/node%u/cpulist", id);
+	if((f = fopen(chemin, "r")) == NULL)
+		return 0;
+	while(fscanf(f, "%u", &debut) == 1){
+		fin = debut;
+		if(fscanf(f, "-%u", &fin) != 1)
+			fin = debut;
+		for(unsigned cpu = debut; cpu <= fin && cpu < t->nb_cpus; cpu++)
+			t->cpu_noeud[cpu] = indice;
+		if(fgetc(f) != ',')
+			break;
+	}
+	fclose(f);
+	return 1;
+}
+
+static void TasPartage_lire_topologie(TasPartage t){
+	long n = sysconf(_SC_NPROCESSORS_CONF);
+
+	t->nb_cpus = (n > 0) ? (unsigned)n : 1;
+	if((t->cpu_noeud = calloc(t->nb_cpus, sizeof(unsigned))) == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir de la topologie");
+		exit(1);
+	}
+	// Les numeros de noeuds peuvent avoir des trous : on les renumerote a partir de 0
+	t->nb_noeuds = 0;
+	for(unsigned id = 0; id < TAS_PARTAGE_NOEUDS_MAX; id++)
+		if(TasPartage_lire_noeud(t, id, t->nb_noeuds))
+			t->nb_noeuds++;
+	if(t->nb_noeuds == 0)
+		t->nb_noeuds = 1;
+}
+
+/*
+ * Creation d'une tranche par un fil place sur son noeud.
+ */
+struct tas_placement{
+	TasPartage t;
+	unsigned indice;
+	Tas_comparateur cmp;
+};
+
+static void* TasPartage_placer(void* arg){
+	struct tas_placement* p = arg;
+	TasPartage t = p->t;
+	unsigned noeud = p->indice / t->par_noeud;
+	struct tas_tranche* tr;
+	cpu_set_t cpus;
+
+	// Sans affinite (conteneur, noyau ancien), la tranche est simplement allouee ici
+	CPU_ZERO(&cpus);
+	for(unsigned cpu = 0; cpu < t->nb_cpus && cpu < CPU_SETSIZE; cpu++)
+		if(t->cpu_noeud[cpu] == noeud)
+			CPU_SET(cpu, &cpus);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+	if(posix_memalign((void**)&tr, TAS_PARTAGE_LIGNE,
+			(sizeof(struct tas_tranche) + TAS_PARTAGE_LIGNE-1) / TAS_PARTAGE_LIGNE * TAS_PARTAGE_LIGNE) != 0){
+		fprintf(stderr, "errueut lors de l'allocation de memoir de la tranche");
+		exit(1);
+	}
+	// Premier acces depuis le noeud : c'est lui qui place les pages
+	memset(tr, 0, sizeof(struct tas_tranche));
+	pthread_mutex_init(&tr->verrou, NULL);
+	Tas_initialiser(&tr->tas, 0);
+	Tas_fixer_comparateur(&tr->tas, p->cmp);
+	tr->noeud = noeud;
+	t->tranches[p->indice] = tr;
+	return NULL;
+}
+
+TasPartage TasPartage_creer(Tas_comparateur cmp, unsigned par_noeud){
+	TasPartage t;
+	struct tas_placement* p;
+	pthread_t* fils;
+
+	if(cmp == NULL){
+		fprintf(stderr, "une file partagee demande un comparateur\n");
+		exit(1);
+	}
+	if((t = malloc(sizeof(struct tas_partage))) == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir de la structure");
+		exit(1);
+	}
+	TasPartage_lire_topologie(t);
+	t->par_noeud = (par_noeud > 0) ? par_noeud : 1;
+	t->nb_tranches = t->nb_noeuds * t->par_noeud;
+
+	if((t->tranches = malloc(t->nb_tranches*sizeof(struct tas_tranche*))) == NULL
+			|| (p = malloc(t->nb_tranches*sizeof(struct tas_placement))) == NULL
+			|| (fils = malloc(t->nb_tranches*sizeof(pthread_t))) == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir des tranches");
+		exit(1);
+	}
+	for(unsigned i = 0; i < t->nb_tranches; i++){
+		p[i].t = t;
+		p[i].indice = i;
+		p[i].cmp = cmp;
+		if(pthread_create(&fils[i], NULL, TasPartage_placer, &p[i]) != 0){
+			fprintf(stderr, "impossible de creer le fil de la tranche %u\n", i);
+			exit(1);
+		}
+	}
+	for(unsigned i = 0; i < t->nb_tranches; i++)
+		pthread_join(fils[i], NULL);
+	free(fils);
+	free(p);
+	return t;
+}
+
+TasPartage TasPartage_detruire(TasPartage t){
+	if(t != NULL){
+		for(unsigned i = 0; i < t->nb_tranches; i++){
+			pthread_mutex_destroy(&t->tranches[i]->verrou);
+			Tas_finaliser(&t->tranches[i]->tas);
+			free(t->tranches[i]);
+		}
+		free(t->tranches);
+		free(t->cpu_noeud);
+		free(t);
+	}
+	return NULL;
+}
+
+// Tranche du processeur qui execute le fil
+static unsigned TasPartage_locale(TasPartage t){
+	int cpu = sched_getcpu();
+
+	if(cpu < 0 || (unsigned)cpu >= t->nb_cpus)
+		cpu = 0;
+	return t->cpu_noeud[cpu]*t->par_noeud + (unsigned)cpu % t->par_noeud;
+}
+
+static void TasPartage_verrouiller(struct tas_tranche* tr){
+	if(pthread_mutex_trylock(&tr->verrou) != 0){
+		pthread_mutex_lock(&tr->verrou);
+		tr->stats.contentions++;
+	}
+}
+
+void TasPartage_ajouter(TasPartage t, void* val){
+	struct tas_tranche* tr = t->tranches[TasPartage_locale(t)];
+
+	TasPartage_verrouiller(tr);
+	Tas_ajouter_valeur(&tr->tas, val);
+	tr->stats.ajouts++;
+	pthread_mutex_unlock(&tr->verrou);
+}
+
+// Enleve le sommet de la tranche i pour un fil dont la tranche locale est locale
+static int TasPartage_prendre(TasPartage t, unsigned i, unsigned locale, void** sortie){
+	struct tas_tranche* tr = t->tranches[i];
+	int pris = 0;
+
+	TasPartage_verrouiller(tr);
+	if(Tas_estVide(&tr->tas))
+		tr->stats.tranches_vides++;
+	else{
+		*sortie = Tas_extraire(&tr->tas);
+		if(i == locale)
+			tr->stats.extractions_locales++;
+		else if(tr->noeud == t->tranches[locale]->noeud)
+			tr->stats.extractions_voisines++;
+		else
+			tr->stats.extractions_distantes++;
+		pris = 1;
+	}
+	pthread_mutex_unlock(&tr->verrou);
+	return pris;
+}
+
+int TasPartage_extraire(TasPartage t, void** sortie){
+	static __thread uint32_t graine = 0;
+	unsigned locale = TasPartage_locale(t);
+
+	if(TasPartage_prendre(t, locale, locale, sortie))
+		return 1;
+	if(t->nb_tranches == 1)
+		return 0;
+
+	if(graine == 0)
+		graine = (uint32_t)(uintptr_t)&graine | 1;
+	for(int i = 0; i < TAS_PARTAGE_ECHANTILLON; i++){
+		// xorshift : chaque fil a sa graine, pas de variable partagee
+		graine ^= graine << 13;
+		graine ^= graine >> 17;
+		graine ^= graine << 5;
+		unsigned j = graine % t->nb_tranches;
+		if(j != locale && TasPartage_prendre(t, j, locale, sortie))
+			return 1;
+	}
+	// Les tranches du meme noeud suivent la tranche locale : elles sont vues en premier
+	for(unsigned i = 1; i < t->nb_tranches; i++)
+		if(TasPartage_prendre(t, (locale+i) % t->nb_tranches, locale, sortie))
+			return 1;
+	return 0;
+}
+
+size_t TasPartage_taille(TasPartage t){
+	size_t taille = 0;
+
+	for(unsigned i = 0; i < t->nb_tranches; i++){
+		pthread_mutex_lock(&t->tranches[i]->verrou);
+		taille += Tas_taille(&t->tranches[i]->tas);
+		pthread_mutex_unlock(&t->tranches[i]->verrou);
+	}
+	return taille;
+}
+
+unsigned TasPartage_nb_noeuds(const TasPartage t){
+	return t->nb_noeuds;
+}
+
+void TasPartage_statistiques(TasPartage t, struct tas_partage_stats* stats){
+	memset(stats, 0, sizeof(struct tas_partage_stats));
+	for(unsigned i = 0; i < t->nb_tranches; i++){
+		struct tas_tranche* tr = t->tranches[i];
+		pthread_mutex_lock(&tr->verrou);
+		stats->ajouts += tr->stats.ajouts;
+		stats->extractions_locales += tr->stats.extractions_locales;
+		stats->extractions_voisines += tr->stats.extractions_voisines;
+		stats->extractions_distantes += tr->stats.extractions_distantes;
+		stats->tranches_vides += tr->stats.tranches_vides;
+		stats->contentions += tr->stats.contentions;
+		pthread_mutex_unlock(&tr->verrou);
+	}
+}
@@ -0,0 +1,134 @@
+/**
+ * \file TasPartage.h
+ * \author Zevio.S et Benharchache.S
+ * \brief File de priorite partagee entre fils, decoupee en tranches par noeud NUMA
+ * \date 18 decembre 2014
+ *
+ * Un seul tas protege par un verrou fait voyager sa ligne de cache (et son
+ * tableau) d'un socket a l'autre a chaque operation. Ici chaque noeud NUMA a
+ * ses tranches : un tas et son verrou, alloues et touches en premier par un
+ * fil place sur le noeud, pour que le noyau mette leurs pages sur ce noeud.
+ * Un ajout va dans la tranche du processeur qui l'execute ; une extraction
+ * prend dans cette tranche, puis dans quelques tranches tirees au hasard,
+ * puis dans toutes les autres.
+ *
+ * L'ordre n'est donc garanti qu'a l'interieur d'une tranche : TasPartage_extraire
+ * rend une petite valeur, pas forcement la plus petite de toutes.
+ *
+ * La topologie est lue dans /sys/devices/system/node. Sans ce repertoire
+ * (ou sur une machine a un seul noeud), il n'y a qu'un noeud.
+ */
+
+#ifndef SOFIEN_STELLA__TASPARTAGE_H__
+#define SOFIEN_STELLA__TASPARTAGE_H__
+
+#include <stdint.h>
+
+#include "Heap.h"
+
+
+/**
+ * \brief Nombre maximal de noeuds NUMA pris en compte.
+ */
+#define TAS_PARTAGE_NOEUDS_MAX 64
+
+/**
+ * \brief Nombre de tranches tirees au hasard quand la tranche locale est vide.
+ */
+#define TAS_PARTAGE_ECHANTILLON 2
+
+
+struct tas_tranche;
+
+/**
+ * \struct tas_partage
+ * \brief Une file de priorite partagee.
+ */
+struct tas_partage{
+	struct tas_tranche** tranches;	/*!< Les tranches du noeud k sont de k*par_noeud a (k+1)*par_noeud-1. */
+	unsigned nb_tranches;		/*!< nb_noeuds*par_noeud. */
+	unsigned par_noeud;		/*!< Nombre de tranches par noeud. */
+	unsigned nb_noeuds;		/*!< Nombre de noeuds NUMA. */
+	unsigned nb_cpus;		/*!< Taille de cpu_noeud. */
+	unsigned* cpu_noeud;		/*!< Noeud de chaque processeur. */
+};
+
+typedef struct tas_partage* TasPartage;
+
+/**
+ * \struct tas_partage_stats
+ * \brief Compteurs cumules de toutes les tranches, qui approchent le trafic entre sockets.
+ */
+struct tas_partage_stats{
+	uint64_t ajouts;		/*!< Ajouts (toujours dans la tranche locale). */
+	uint64_t extractions_locales;	/*!< Extractions servies par la tranche du fil. */
+	uint64_t extractions_voisines;	/*!< Extractions servies par une autre tranche du meme noeud. */
+	uint64_t extractions_distantes;	/*!< Extractions servies par une tranche d'un autre noeud. */
+	uint64_t tranches_vides;	/*!< Tranches verrouillees pour rien pendant une extraction. */
+	uint64_t contentions;		/*!< Verrous trouves deja pris. */
+};
+
+
+/**
+ * \fn TasPartage TasPartage_creer(Tas_comparateur cmp, unsigned par_noeud)
+ * \brief Cree une file partagee.
+ *
+ * Plusieurs tranches par noeud reduisent l'attente sur les verrous quand
+ * beaucoup de fils d'un meme noeud travaillent sur la file.
+ *
+ * \param cmp L'ordre des valeurs (non NULL).
+ * \param par_noeud Nombre de tranches par noeud (1 si 0).
+ * \return La file.
+ */
+TasPartage TasPartage_creer(Tas_comparateur cmp, unsigned par_noeud);
+
+
+/**
+ * \fn TasPartage TasPartage_detruire(TasPartage t)
+ * \brief Detruit la file. Aucun fil ne doit plus l'utiliser.
+ *
+ * \return NULL.
+ */
+TasPartage TasPartage_detruire(TasPartage t);
+
+
+/**
+ * \fn void TasPartage_ajouter(TasPartage t, void* val)
+ * \brief Ajoute une valeur dans la tranche locale. Peut etre appelee par plusieurs fils a la fois.
+ */
+void TasPartage_ajouter(TasPartage t, void* val);
+
+
+/**
+ * \fn int TasPartage_extraire(TasPartage t, void** sortie)
+ * \brief Enleve une petite valeur. Peut etre appelee par plusieurs fils a la fois.
+ *
+ * \param t La file.
+ * \param sortie Recoit la valeur enlevee.
+ * \return 1 si une valeur a ete enlevee, 0 si toutes les tranches etaient vides au moment ou elles ont ete vues.
+ */
+int TasPartage_extraire(TasPartage t, void** sortie);
+
+
+/**
+ * \fn size_t TasPartage_taille(TasPartage t)
+ * \brief Retourne le nombre de valeurs (exact seulement si aucun fil ne modifie la file).
+ */
+size_t TasPartage_taille(TasPartage t);
+
+
+/**
+ * \fn unsigned TasPartage_nb_noeuds(const TasPartage t)
+ * \brief Retourne le nombre de noeuds NUMA vus a la creation.
+ */
+unsigned TasPartage_nb_noeuds(const TasPartage t);
+
+
+/**
+ * \fn void TasPartage_statistiques(TasPartage t, struct tas_partage_stats* stats)
+ * \brief Remplit stats avec la somme des compteurs des tranches.
+ */
+void TasPartage_statistiques(TasPartage t, struct tas_partage_stats* stats);
+
+
+#endif
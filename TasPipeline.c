@@ -0,0 +1,191 @@
+/**
+ * \file TasPipeline.c
+ * \author Zevio.S et Benharchache.S
+ * \brief Fichier source de l'etage de pipeline
+ * \date 18 decembre 2014
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "TasPipeline.h"
+
+// Fil consommateur : vide l'anneau par lots dans le tas
+static void* TasPipeline_consommer(void* arg){
+	TasPipeline p = arg;
+	void* lot[TAS_PIPELINE_LOT];
+
+	pthread_mutex_lock(&p->verrou);
+	for(;;){
+		while(p->tete == p->queue && !p->ferme){
+			p->endormi = 1;
+			pthread_cond_wait(&p->non_vide, &p->verrou);
+		}
+		p->endormi = 0;
+		if(p->tete == p->queue)
+			break;
+
+		size_t n = 0;
+		while(n < TAS_PIPELINE_LOT && p->tete != p->queue)
+			lot[n++] = p->anneau[p->tete++ & (p->capacite-1)];
+		p->stats.lots++;
+		// L'anneau a de la place : un producteur attend peut-etre
+		pthread_cond_broadcast(&p->place);
+		pthread_mutex_unlock(&p->verrou);
+
+		pthread_mutex_lock(&p->verrou_tas);
+		for(size_t i = 0; i < n; i++)
+			Tas_ajouter_valeur(&p->tas, lot[i]);
+		pthread_cond_signal(&p->pret);
+		pthread_mutex_unlock(&p->verrou_tas);
+
+		pthread_mutex_lock(&p->verrou);
+	}
+	pthread_mutex_unlock(&p->verrou);
+
+	pthread_mutex_lock(&p->verrou_tas);
+	p->fini = 1;
+	pthread_cond_broadcast(&p->pret);
+	pthread_mutex_unlock(&p->verrou_tas);
+	return NULL;
+}
+
+TasPipeline TasPipeline_creer(Tas_comparateur cmp, size_t capacite, size_t basse, size_t haute){
+	TasPipeline p;
+
+	if(cmp == NULL || haute == 0 || basse >= haute){
+		fprintf(stderr, "un etage demande un comparateur et 0 <= basse < haute\n");
+		exit(1);
+	}
+	if((p = malloc(sizeof(struct tas_pipeline))) == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir de la structure");
+		exit(1);
+	}
+	p->capacite = 1;
+	while(p->capacite < capacite)
+		p->capacite *= 2;
+	if((p->anneau = malloc(p->capacite*sizeof(void*))) == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir de l'anneau");
+		exit(1);
+	}
+	p->tete = 0;
+	p->queue = 0;
+	p->en_cours = 0;
+	p->basse = basse;
+	p->haute = haute;
+	p->sature = 0;
+	p->ferme = 0;
+	p->endormi = 0;
+	p->fini = 0;
+	pthread_mutex_init(&p->verrou, NULL);
+	pthread_cond_init(&p->non_vide, NULL);
+	pthread_cond_init(&p->place, NULL);
+	pthread_mutex_init(&p->verrou_tas, NULL);
+	pthread_cond_init(&p->pret, NULL);
+	Tas_initialiser(&p->tas, 0);
+	Tas_fixer_comparateur(&p->tas, cmp);
+	p->stats = (struct tas_pipeline_stats){0, 0, 0, 0, 0, 0};
+
+	if(pthread_create(&p->consommateur, NULL, TasPipeline_consommer, p) != 0){
+		fprintf(stderr, "impossible de creer le fil consommateur\n");
+		exit(1);
+	}
+	return p;
+}
+
+TasPipeline TasPipeline_detruire(TasPipeline p){
+	if(p != NULL){
+		TasPipeline_fermer(p);
+		pthread_join(p->consommateur, NULL);
+		Tas_finaliser(&p->tas);
+		pthread_cond_destroy(&p->pret);
+		pthread_mutex_destroy(&p->verrou_tas);
+		pthread_cond_destroy(&p->place);
+		pthread_cond_destroy(&p->non_vide);
+		pthread_mutex_destroy(&p->verrou);
+		free(p->anneau);
+		free(p);
+	}
+	return NULL;
+}
+
+void TasPipeline_envoyer_lot(TasPipeline p, void* const* valeurs, size_t n){
+	size_t i = 0;
+
+	pthread_mutex_lock(&p->verrou);
+	if(p->ferme){
+		fprintf(stderr, "envoi sur un etage ferme\n");
+		exit(1);
+	}
+	while(i < n){
+		if(p->queue - p->tete == p->capacite || p->sature){
+			p->stats.attentes++;
+			while(p->queue - p->tete == p->capacite || p->sature)
+				pthread_cond_wait(&p->place, &p->verrou);
+		}
+		while(i < n && p->queue - p->tete < p->capacite && !p->sature){
+			p->anneau[p->queue++ & (p->capacite-1)] = valeurs[i++];
+			p->stats.envoyees++;
+			if(++p->en_cours >= p->haute){
+				p->sature = 1;
+				p->stats.saturations++;
+			}
+		}
+		// Un seul reveil pour tout ce qui vient d'etre depose
+		if(p->endormi){
+			p->endormi = 0;
+			p->stats.reveils++;
+			pthread_cond_signal(&p->non_vide);
+		}
+	}
+	pthread_mutex_unlock(&p->verrou);
+}
+
+void TasPipeline_envoyer(TasPipeline p, void* val){
+	TasPipeline_envoyer_lot(p, &val, 1);
+}
+
+int TasPipeline_sature(TasPipeline p){
+	pthread_mutex_lock(&p->verrou);
+	int sature = p->sature;
+	pthread_mutex_unlock(&p->verrou);
+	return sature;
+}
+
+void TasPipeline_fermer(TasPipeline p){
+	pthread_mutex_lock(&p->verrou);
+	p->ferme = 1;
+	pthread_cond_signal(&p->non_vide);
+	pthread_mutex_unlock(&p->verrou);
+}
+
+size_t TasPipeline_recevoir_lot(TasPipeline p, void** sortie, size_t max){
+	size_t n = 0;
+
+	pthread_mutex_lock(&p->verrou_tas);
+	while(Tas_estVide(&p->tas) && !p->fini)
+		pthread_cond_wait(&p->pret, &p->verrou_tas);
+	while(n < max && !Tas_estVide(&p->tas))
+		sortie[n++] = Tas_extraire(&p->tas);
+	p->stats.sorties += n;
+	pthread_mutex_unlock(&p->verrou_tas);
+
+	if(n > 0){
+		pthread_mutex_lock(&p->verrou);
+		p->en_cours -= n;
+		if(p->sature && p->en_cours <= p->basse){
+			p->sature = 0;
+			pthread_cond_broadcast(&p->place);
+		}
+		pthread_mutex_unlock(&p->verrou);
+	}
+	return n;
+}
+
+void TasPipeline_statistiques(TasPipeline p, struct tas_pipeline_stats* stats){
+	pthread_mutex_lock(&p->verrou);
+	pthread_mutex_lock(&p->verrou_tas);
+	*stats = p->stats;
+	pthread_mutex_unlock(&p->verrou_tas);
+	pthread_mutex_unlock(&p->verrou);
+}
@@ -0,0 +1,147 @@
+/**
+ * \file TasPipeline.h
+ * \author Zevio.S et Benharchache.S
+ * \brief Etage de pipeline : anneau d'entree, tas de reordonnancement et sortie par lots
+ * \date 18 decembre 2014
+ *
+ * Les producteurs deposent des valeurs dans un anneau borne. Un fil
+ * consommateur, cree avec l'etage, vide l'anneau par lots (un verrou et au
+ * plus un reveil par lot, pas par valeur) et les ajoute au tas. La sortie
+ * retire du tas des lots de valeurs dans l'ordre du comparateur.
+ *
+ * Contre-pression : quand les valeurs envoyees mais pas encore sorties
+ * atteignent la marque haute, l'etage est sature et les envois attendent
+ * qu'elles redescendent a la marque basse.
+ *
+ *   producteurs -> [anneau] -> consommateur -> [tas] -> TasPipeline_recevoir_lot
+ */
+
+#ifndef SOFIEN_STELLA__TASPIPELINE_H__
+#define SOFIEN_STELLA__TASPIPELINE_H__
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include "Heap.h"
+
+
+/**
+ * \brief Nombre maximal de valeurs que le consommateur prend dans l'anneau a la fois.
+ */
+#define TAS_PIPELINE_LOT 256
+
+
+/**
+ * \struct tas_pipeline_stats
+ * \brief Compteurs de l'etage.
+ */
+struct tas_pipeline_stats{
+	uint64_t envoyees;		/*!< Valeurs deposees dans l'anneau. */
+	uint64_t sorties;		/*!< Valeurs rendues par TasPipeline_recevoir_lot. */
+	uint64_t lots;			/*!< Lots pris dans l'anneau par le consommateur. */
+	uint64_t reveils;		/*!< Reveils du consommateur par un producteur. */
+	uint64_t attentes;		/*!< Envois mis en attente (anneau plein ou etage sature). */
+	uint64_t saturations;		/*!< Passages de la marque haute. */
+};
+
+/**
+ * \struct tas_pipeline
+ * \brief Un etage de pipeline.
+ */
+struct tas_pipeline{
+	void** anneau;			/*!< Valeurs pas encore prises par le consommateur. */
+	size_t capacite;		/*!< Taille de l'anneau (puissance de deux). */
+	uint64_t tete;			/*!< Nombre de valeurs prises dans l'anneau. */
+	uint64_t queue;			/*!< Nombre de valeurs deposees dans l'anneau. */
+	size_t en_cours;		/*!< Valeurs envoyees et pas encore sorties. */
+	size_t basse;			/*!< Marque basse. */
+	size_t haute;			/*!< Marque haute. */
+	int sature;			/*!< 1 entre le passage de la marque haute et le retour a la marque basse. */
+	int ferme;			/*!< 1 apres TasPipeline_fermer. */
+	int endormi;			/*!< 1 quand le consommateur attend des valeurs. */
+	pthread_mutex_t verrou;		/*!< Protege l'anneau, en_cours et les drapeaux. */
+	pthread_cond_t non_vide;	/*!< Reveille le consommateur. */
+	pthread_cond_t place;		/*!< Reveille les producteurs. */
+
+	struct heap_struct tas;		/*!< Valeurs prises dans l'anneau, pas encore sorties. */
+	int fini;			/*!< 1 quand le consommateur a tout ajoute au tas apres la fermeture. */
+	pthread_mutex_t verrou_tas;	/*!< Protege le tas et fini. */
+	pthread_cond_t pret;		/*!< Reveille la sortie. */
+
+	pthread_t consommateur;
+	struct tas_pipeline_stats stats;	/*!< Proteges par verrou, sauf sorties (verrou_tas). */
+};
+
+typedef struct tas_pipeline* TasPipeline;
+
+
+/**
+ * \fn TasPipeline TasPipeline_creer(Tas_comparateur cmp, size_t capacite, size_t basse, size_t haute)
+ * \brief Cree un etage et demarre son fil consommateur.
+ *
+ * \param cmp L'ordre de sortie des valeurs (non NULL).
+ * \param capacite Taille de l'anneau, arrondie a la puissance de deux superieure.
+ * \param basse Marque basse (strictement inferieure a haute).
+ * \param haute Marque haute (au moins 1).
+ * \return L'etage.
+ */
+TasPipeline TasPipeline_creer(Tas_comparateur cmp, size_t capacite, size_t basse, size_t haute);
+
+
+/**
+ * \fn TasPipeline TasPipeline_detruire(TasPipeline p)
+ * \brief Ferme l'etage, attend son consommateur et le detruit. Les valeurs pas encore sorties sont perdues.
+ *
+ * \return NULL.
+ */
+TasPipeline TasPipeline_detruire(TasPipeline p);
+
+
+/**
+ * \fn void TasPipeline_envoyer_lot(TasPipeline p, void* const* valeurs, size_t n)
+ * \brief Depose n valeurs, en attendant tant que l'anneau est plein ou l'etage sature.
+ */
+void TasPipeline_envoyer_lot(TasPipeline p, void* const* valeurs, size_t n);
+
+
+/**
+ * \fn void TasPipeline_envoyer(TasPipeline p, void* val)
+ * \brief Depose une valeur (TasPipeline_envoyer_lot avec n = 1).
+ */
+void TasPipeline_envoyer(TasPipeline p, void* val);
+
+
+/**
+ * \fn int TasPipeline_sature(TasPipeline p)
+ * \brief Retourne 1 si un envoi attendrait la marque basse, 0 sinon.
+ */
+int TasPipeline_sature(TasPipeline p);
+
+
+/**
+ * \fn void TasPipeline_fermer(TasPipeline p)
+ * \brief Signale qu'il n'y aura plus d'envoi. La sortie rend encore les valeurs deja envoyees.
+ */
+void TasPipeline_fermer(TasPipeline p);
+
+
+/**
+ * \fn size_t TasPipeline_recevoir_lot(TasPipeline p, void** sortie, size_t max)
+ * \brief Attend qu'il y ait des valeurs dans le tas et en retire au plus max, dans l'ordre.
+ *
+ * \param p L'etage.
+ * \param sortie Recoit les valeurs.
+ * \param max Taille de sortie (au moins 1).
+ * \return Le nombre de valeurs retirees, 0 quand l'etage est ferme et vide.
+ */
+size_t TasPipeline_recevoir_lot(TasPipeline p, void** sortie, size_t max);
+
+
+/**
+ * \fn void TasPipeline_statistiques(TasPipeline p, struct tas_pipeline_stats* stats)
+ * \brief Copie les compteurs de l'etage dans stats.
+ */
+void TasPipeline_statistiques(TasPipeline p, struct tas_pipeline_stats* stats);
+
+
+#endif
@@ -0,0 +1,233 @@
+/**
+ * \file Trace.c
+ * \author Zevio.S et Benharchache.S
+ * \brief Fichier source de l'enregistrement des operations
+ * \date 18 decembre 2014
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "Trace.h"
+
+#define TRACE_MAGIQUE "BSDTRACE"
+#define TRACE_VERSION 3
+
+/*
+ * En-tete du fichier, suivi des evenements.
+ */
+struct trace_fichier_entete{
+	char magique[8];
+	uint32_t version;
+	uint32_t taille_evenement;
+};
+
+/*
+ * Tampon d'un fil. generation dit pour quelle trace il a ete rempli : un
+ * tampon reste d'une trace arretee est oublie par la suivante.
+ */
+struct trace_tampon{
+	size_t n;
+	unsigned fil;
+	unsigned generation;
+	struct trace_evenement evenements[TRACE_TAMPON];
+};
+
+static int trace_fd = -1;		// -1 sans trace en cours
+static unsigned trace_ecritures;	// vidages de tampon en cours, attendus par Trace_arreter
+static unsigned trace_generation;
+static uint64_t trace_debut;
+static unsigned trace_nb_fils;
+static __thread struct trace_tampon* trace_tampon;
+static pthread_key_t trace_cle;		// vide et libere le tampon a la fin du fil
+static pthread_once_t trace_cle_creee = PTHREAD_ONCE_INIT;
+
+static uint64_t Trace_horloge(void){
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec*1000000000u + (uint64_t)t.tv_nsec;
+}
+
+// write() jusqu'au bout, en reprenant apres une ecriture partielle
+static int Trace_ecrire_tout(int fd, const void* donnees, size_t n){
+	const char* p = donnees;
+	while(n > 0){
+		ssize_t k = write(fd, p, n);
+		if(k < 0){
+			if(errno == EINTR)
+				continue;
+			return -1;
+		}
+		p += k;
+		n -= (size_t)k;
+	}
+	return 0;
+}
+
+// Le vidage s'annonce avant de lire trace_fd, et Trace_arreter retire trace_fd
+// avant de compter les vidages annonces (ordre sequentiel des deux cotes) :
+// un vidage qui a lu le descripteur est toujours attendu avant close().
+static void Trace_vider_tampon(struct trace_tampon* t){
+	__atomic_add_fetch(&trace_ecritures, 1, __ATOMIC_SEQ_CST);
+	int fd = __atomic_load_n(&trace_fd, __ATOMIC_SEQ_CST);
+	if(fd >= 0 && t->n > 0 && t->generation == __atomic_load_n(&trace_generation, __ATOMIC_RELAXED))
+		Trace_ecrire_tout(fd, t->evenements, t->n*sizeof(struct trace_evenement));
+	__atomic_sub_fetch(&trace_ecritures, 1, __ATOMIC_RELEASE);
+	t->n = 0;
+}
+
+static void Trace_fin_du_fil(void* arg){
+	Trace_vider_tampon(arg);
+	free(arg);
+}
+
+static void Trace_creer_cle(void){
+	pthread_key_create(&trace_cle, Trace_fin_du_fil);
+}
+
+int Trace_demarrer(const char* chemin){
+	if(__atomic_load_n(&trace_fd, __ATOMIC_ACQUIRE) >= 0)
+		return -1;
+	// O_APPEND : les write() des tampons de plusieurs fils ne s'ecrasent pas
+	int fd = open(chemin, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+	if(fd < 0)
+		return -1;
+	struct trace_fichier_entete entete;
+	memset(&entete, 0, sizeof(entete));
+	memcpy(entete.magique, TRACE_MAGIQUE, sizeof(entete.magique));
+	entete.version = TRACE_VERSION;
+	entete.taille_evenement = sizeof(struct trace_evenement);
+	if(Trace_ecrire_tout(fd, &entete, sizeof(entete)) < 0){
+		close(fd);
+		return -1;
+	}
+	trace_debut = Trace_horloge();
+	__atomic_add_fetch(&trace_generation, 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&trace_fd, fd, __ATOMIC_RELEASE);
+	return 0;
+}
+
+void Trace_arreter(void){
+	Trace_vider();
+	int fd = __atomic_exchange_n(&trace_fd, -1, __ATOMIC_SEQ_CST);
+	if(fd < 0)
+		return;
+	while(__atomic_load_n(&trace_ecritures, __ATOMIC_SEQ_CST) > 0)
+		sched_yield();
+	close(fd);
+}
+
+void Trace_vider(void){
+	if(trace_tampon != NULL)
+		Trace_vider_tampon(trace_tampon);
+}
+
+void Trace_evenement(enum trace_operation op, const void* objet, uint64_t arg){
+	if(__atomic_load_n(&trace_fd, __ATOMIC_ACQUIRE) < 0)
+		return;
+	unsigned generation = __atomic_load_n(&trace_generation, __ATOMIC_RELAXED);
+	struct trace_tampon* t = trace_tampon;
+	if(t == NULL){
+		pthread_once(&trace_cle_creee, Trace_creer_cle);
+		if((t = malloc(sizeof(struct trace_tampon))) == NULL)
+			return; // on perd l'evenement plutot que d'arreter le programme trace
+		t->n = 0;
+		t->fil = __atomic_fetch_add(&trace_nb_fils, 1, __ATOMIC_RELAXED);
+		t->generation = generation;
+		pthread_setspecific(trace_cle, t);
+		trace_tampon = t;
+	}
+	if(t->generation != generation){
+		t->n = 0;
+		t->generation = generation;
+	}
+	struct trace_evenement* e = &t->evenements[t->n];
+	e->objet = (uint64_t)(uintptr_t)objet;
+	e->arg = arg;
+	e->date = Trace_horloge() - trace_debut;
+	e->fil = t->fil;
+	e->operation = (uint32_t)op;
+	if(++t->n == TRACE_TAMPON)
+		Trace_vider_tampon(t);
+}
+
+// Tri fusion stable par date : deux evenements d'un meme fil gardent leur ordre
+static void Trace_trier(struct trace_evenement* e, struct trace_evenement* tmp, size_t n){
+	for(size_t largeur = 1; largeur < n; largeur *= 2){
+		for(size_t g = 0; g < n; g += 2*largeur){
+			size_t m = (g + largeur < n) ? g + largeur : n;
+			size_t d = (g + 2*largeur < n) ? g + 2*largeur : n;
+			size_t i = g, j = m, k = g;
+			while(i < m && j < d)
+				tmp[k++] = (TRACE_DATE(&e[j]) < TRACE_DATE(&e[i])) ? e[j++] : e[i++];
+			while(i < m)
+				tmp[k++] = e[i++];
+			while(j < d)
+				tmp[k++] = e[j++];
+		}
+		memcpy(e, tmp, n*sizeof(struct trace_evenement));
+	}
+}
+
+struct trace_evenement* Trace_lire(const char* chemin, size_t* nb){
+	struct trace_fichier_entete entete;
+	struct trace_evenement* e = NULL;
+	struct stat st;
+	FILE* f;
+
+	if((f = fopen(chemin, "rb")) == NULL)
+		return NULL;
+	if(fread(&entete, sizeof(entete), 1, f) != 1
+	   || memcmp(entete.magique, TRACE_MAGIQUE, sizeof(entete.magique)) != 0
+	   || entete.version != TRACE_VERSION
+	   || entete.taille_evenement != sizeof(struct trace_evenement)
+	   || fstat(fileno(f), &st) < 0){
+		fclose(f);
+		return NULL;
+	}
+	// Un dernier evenement tronque (arret brutal) est ignore
+	size_t n = ((size_t)st.st_size - sizeof(entete)) / sizeof(struct trace_evenement);
+	if((e = malloc((n ? n : 1)*sizeof(struct trace_evenement))) == NULL
+	   || fread(e, sizeof(struct trace_evenement), n, f) != n){
+		free(e);
+		fclose(f);
+		return NULL;
+	}
+	fclose(f);
+
+	int plusieurs_fils = 0;
+	for(size_t i = 1; i < n && !plusieurs_fils; i++)
+		plusieurs_fils = TRACE_FIL(&e[i]) != TRACE_FIL(&e[0]);
+	if(plusieurs_fils){
+		struct trace_evenement* tmp = malloc(n*sizeof(struct trace_evenement));
+		if(tmp == NULL){
+			free(e);
+			return NULL;
+		}
+		Trace_trier(e, tmp, n);
+		free(tmp);
+	}
+	*nb = n;
+	return e;
+}
+
+#ifdef BIBLISD_TRACE
+
+// BIBLISD_TRACE_FICHIER=chemin : trace de tout le programme, sans le modifier
+__attribute__((constructor)) static void Trace_depuis_environnement(void){
+	const char* chemin = getenv("BIBLISD_TRACE_FICHIER");
+	if(chemin != NULL && *chemin != '\0' && Trace_demarrer(chemin) == 0)
+		atexit(Trace_arreter);
+}
+
+#endif
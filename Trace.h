@@ -0,0 +1,138 @@
+/**
+ * \file Trace.h
+ * \author Zevio.S et Benharchache.S
+ * \brief Enregistrement des operations sur les conteneurs dans un fichier binaire
+ * \date 18 decembre 2014
+ *
+ * Les appels aux fonctions du tas et de la liste ne sont enregistres que si
+ * BIBLISD_TRACE est defini a la compilation (make TRACE=1). Sinon la macro
+ * TRACE est vide et le code des conteneurs est identique a celui compile sans
+ * ce fichier.
+ *
+ * Chaque fil ecrit ses evenements dans son propre tampon, sans verrou ni
+ * operation atomique, et le vide dans le fichier d'un seul write() quand il
+ * est plein, a la fin du fil ou a l'arret de la trace. Les evenements de
+ * plusieurs fils sont remis dans l'ordre de leurs dates a la lecture.
+ *
+ * Avec BIBLISD_TRACE, la variable d'environnement BIBLISD_TRACE_FICHIER
+ * demarre la trace au lancement du programme et l'arrete a sa sortie, sans
+ * modifier le programme : BIBLISD_TRACE_FICHIER=prod.trace ./programme
+ *
+ * Le fichier se rejoue avec ./rejouer prod.trace (voir rejouer.c).
+ */
+
+#ifndef SOFIEN_STELLA__TRACE_H__
+#define SOFIEN_STELLA__TRACE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/**
+ * \brief Nombre d'evenements du tampon de chaque fil.
+ */
+#define TRACE_TAMPON 4096
+
+/**
+ * \enum trace_operation
+ * \brief Les operations enregistrees. Celles du tas precedent TRACE_LISTE_CREER.
+ */
+enum trace_operation{
+	TRACE_TAS_CREER,		/*!< Tas_creer */
+	TRACE_TAS_DETRUIRE,		/*!< Tas_detruire */
+	TRACE_TAS_COPIER,		/*!< Tas_creerTasParCopie, arg : le tas copie */
+	TRACE_TAS_AJOUTER,		/*!< Tas_ajouter_valeur, arg : la valeur */
+	TRACE_TAS_EXTRAIRE,		/*!< Tas_extraire */
+	TRACE_TAS_ENLEVER,		/*!< Tas_enlever_valeur, arg : la position */
+	TRACE_TAS_CONCATENER,		/*!< Tas_concatener, arg : le tas ajoute */
+	TRACE_TAS_VIDER,		/*!< Tas_vider */
+	TRACE_TAS_BORNER,		/*!< Tas_creerBorne (apres TRACE_TAS_CREER), arg : la borne k */
+	TRACE_TAS_PROPOSER,		/*!< Tas_proposer (et Tas_ajouter_valeur d'un tas borne), arg : la valeur */
+	TRACE_LISTE_CREER,		/*!< ll_create */
+	TRACE_LISTE_DETRUIRE,		/*!< ll_destroy */
+	TRACE_LISTE_CLONER,		/*!< ll_clone, arg : la liste copiee */
+	TRACE_LISTE_INSERER,		/*!< ll_insert (et ll_push_front), arg : la position */
+	TRACE_LISTE_AJOUTER_FIN,	/*!< ll_push_back */
+	TRACE_LISTE_ACCEDER,		/*!< ll_get, arg : la position */
+	TRACE_LISTE_RETIRER,		/*!< ll_remove_at, arg : la position */
+	TRACE_LISTE_RETIRER_TETE,	/*!< ll_pop_front */
+	TRACE_LISTE_RETIRER_FIN,	/*!< ll_pop_back */
+	TRACE_LISTE_VIDER,		/*!< ll_reset */
+	TRACE_NB_OPERATIONS
+};
+
+/**
+ * \struct trace_evenement
+ * \brief Un enregistrement du fichier (32 octets).
+ */
+struct trace_evenement{
+	uint64_t objet;		/*!< Adresse du conteneur, qui l'identifie entre sa creation et sa destruction. */
+	uint64_t arg;		/*!< Valeur, position ou autre conteneur selon l'operation. */
+	uint64_t date;		/*!< Date en ns depuis le debut de la trace, sur 64 bits : pas de retour a zero. */
+	uint32_t fil;		/*!< Numero du fil, dans l'ordre de leur premier evenement. */
+	uint32_t operation;	/*!< Une enum trace_operation. */
+};
+
+#define TRACE_DATE(e) ((e)->date)
+#define TRACE_FIL(e) ((unsigned)(e)->fil)
+#define TRACE_OPERATION(e) ((enum trace_operation)(e)->operation)
+
+
+/**
+ * \fn int Trace_demarrer(const char* chemin)
+ * \brief Cree le fichier de trace et commence a enregistrer.
+ *
+ * \param chemin Le fichier, ecrase s'il existe.
+ * \return 0, ou -1 si le fichier ne peut pas etre cree ou si une trace est deja en cours.
+ */
+int Trace_demarrer(const char* chemin);
+
+
+/**
+ * \fn void Trace_arreter(void)
+ * \brief Vide le tampon du fil appelant et ferme le fichier.
+ *
+ * Les tampons des autres fils sont vides a leur fin : on arrete la trace
+ * apres les avoir attendus. Un fil qui vide son tampon pendant l'arret
+ * termine son ecriture avant la fermeture du fichier.
+ */
+void Trace_arreter(void);
+
+
+/**
+ * \fn void Trace_evenement(enum trace_operation op, const void* objet, uint64_t arg)
+ * \brief Enregistre une operation dans le tampon du fil appelant. Ne fait rien sans trace en cours.
+ */
+void Trace_evenement(enum trace_operation op, const void* objet, uint64_t arg);
+
+
+/**
+ * \fn void Trace_vider(void)
+ * \brief Ecrit dans le fichier les evenements du tampon du fil appelant.
+ */
+void Trace_vider(void);
+
+
+/**
+ * \fn struct trace_evenement* Trace_lire(const char* chemin, size_t* nb)
+ * \brief Charge un fichier de trace, evenements tries par date.
+ *
+ * \param chemin Le fichier.
+ * \param nb Recoit le nombre d'evenements.
+ * \return Les evenements (a liberer avec free), ou NULL si le fichier n'est pas une trace lisible.
+ */
+struct trace_evenement* Trace_lire(const char* chemin, size_t* nb);
+
+
+#ifdef BIBLISD_TRACE
+
+#define TRACE(op, objet, arg) Trace_evenement(op, objet, (uint64_t)(arg))
+
+#else
+
+#define TRACE(op, objet, arg) ((void)0)
+
+#endif
+
+
+#endif
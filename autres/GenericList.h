@@ -0,0 +1,198 @@
+/*
+ * This file is a part of the C LinkedList library.
+ *
+ * File:   GenericList.h
+ * Author: Loïc FORTIN <loic.fortin@etud.univ-montp2.fr>
+ *
+ * Typed doubly linked lists generated by a macro.
+ *
+ * DEFINE_LIST(name, T) defines the type name, a list whose nodes hold a T directly
+ * (no separate allocation per value, no void*), and the static inline functions
+ * name_init, name_fini, name_push_front, name_push_back, name_pop_front, name_pop_back,
+ * name_first, name_last, name_get, name_contains, name_remove_node and name_size.
+ * Removed nodes are kept for the next insertions until name_fini.
+ *
+ * DEFINE_LIST(IntList, int)
+ *
+ * IntList list;
+ * IntList_init(&list);
+ * IntList_push_back(&list, 42);
+ * for(struct IntList_node* ite = list.first; ite; ite = ite->next)
+ *     use(ite->value);
+ * IntList_fini(&list);
+ *
+ * The LinkedList of LinkedList.h stays the void* instance, which owns and frees its values.
+ */
+
+#ifndef GENERICLIST_H
+#define GENERICLIST_H
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdbool.h> // bool
+#include <string.h> // memcmp
+#include "LinkedList.h" // Exception codes
+
+#define DEFINE_LIST(name, T) \
+ \
+struct name##_node { \
+    T value; \
+    struct name##_node* previous; \
+    struct name##_node* next; \
+}; \
+ \
+typedef struct name { \
+    struct name##_node* first; \
+    struct name##_node* last; \
+    struct name##_node* free_nodes; /* Removed nodes, linked by next */ \
+    size_t length; \
+} name; \
+ \
+static inline void name##_init(name* list) { \
+    list->first = NULL; \
+    list->last = NULL; \
+    list->free_nodes = NULL; \
+    list->length = 0; \
+} \
+ \
+static inline void name##_fini(name* list) { \
+    struct name##_node* tmp; \
+    \
+    while(list->first) { \
+        tmp = list->first->next; \
+        free(list->first); \
+        list->first = tmp; \
+    } \
+    \
+    while(list->free_nodes) { \
+        tmp = list->free_nodes->next; \
+        free(list->free_nodes); \
+        list->free_nodes = tmp; \
+    } \
+    \
+    name##_init(list); \
+} \
+ \
+static inline struct name##_node* name##_node_alloc(name* list, T value) { \
+    struct name##_node* node = list->free_nodes; \
+    \
+    if(node) \
+        list->free_nodes = node->next; \
+    else if(!(node = (struct name##_node*) malloc(sizeof(struct name##_node)))) \
+        exit(MEMORY_ALLOCATION_FAIL_EXCEPTION); \
+    \
+    node->value = value; \
+    ++list->length; \
+    return node; \
+} \
+ \
+static inline void name##_push_front(name* list, T value) { \
+    struct name##_node* node = name##_node_alloc(list, value); \
+    \
+    node->previous = NULL; \
+    node->next = list->first; \
+    \
+    if(list->first) \
+        list->first->previous = node; \
+    else \
+        list->last = node; \
+    \
+    list->first = node; \
+} \
+ \
+static inline void name##_push_back(name* list, T value) { \
+    struct name##_node* node = name##_node_alloc(list, value); \
+    \
+    node->previous = list->last; \
+    node->next = NULL; \
+    \
+    if(list->last) \
+        list->last->next = node; \
+    else \
+        list->first = node; \
+    \
+    list->last = node; \
+} \
+ \
+/* The node goes to the free list: it must not be used afterwards */ \
+static inline void name##_remove_node(name* list, struct name##_node* node) { \
+    if(node->previous) \
+        node->previous->next = node->next; \
+    else \
+        list->first = node->next; \
+    \
+    if(node->next) \
+        node->next->previous = node->previous; \
+    else \
+        list->last = node->previous; \
+    \
+    node->next = list->free_nodes; \
+    list->free_nodes = node; \
+    --list->length; \
+} \
+ \
+static inline T name##_first(const name* list) { \
+    if(!list->first) \
+        exit(EMPTY_LIST_EXCEPTION); \
+    \
+    return list->first->value; \
+} \
+ \
+static inline T name##_last(const name* list) { \
+    if(!list->last) \
+        exit(EMPTY_LIST_EXCEPTION); \
+    \
+    return list->last->value; \
+} \
+ \
+static inline T name##_pop_front(name* list) { \
+    T value = name##_first(list); \
+    \
+    name##_remove_node(list, list->first); \
+    return value; \
+} \
+ \
+static inline T name##_pop_back(name* list) { \
+    T value = name##_last(list); \
+    \
+    name##_remove_node(list, list->last); \
+    return value; \
+} \
+ \
+static inline T name##_get(const name* list, size_t index) { \
+    if(index >= list->length) \
+        exit(INDEX_OUT_OF_RANGE_EXCEPTION); \
+    \
+    struct name##_node* ite; \
+    \
+    if(index < list->length / 2) \
+        for(ite = list->first; index > 0; --index) \
+            ite = ite->next; \
+    else \
+        for(ite = list->last, index = list->length - 1 - index; index > 0; --index) \
+            ite = ite->previous; \
+    \
+    return ite->value; \
+} \
+ \
+/* Compares the sizeof(T) bytes of the values: the padding of a structure T must be zeroed */ \
+static inline bool name##_contains(const name* list, T value) { \
+    for(struct name##_node* ite = list->first; ite; ite = ite->next) \
+        if(memcmp(&ite->value, &value, sizeof(T)) == 0) \
+            return true; \
+    \
+    return false; \
+} \
+ \
+static inline size_t name##_size(const name* list) { \
+    return list->length; \
+}
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  /* GENERICLIST_H */
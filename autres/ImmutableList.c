@@ -0,0 +1,72 @@
+/*
+ * This file is a part of the C LinkedList library.
+ *
+ * File:   ImmutableList.c
+ * Author: Loïc FORTIN <loic.fortin@etud.univ-montp2.fr>
+ */
+
+#include "ImmutableList.h"
+
+void* il_first(const struct ImmutableList* list) {
+    if(!list)
+        exit(EMPTY_LIST_EXCEPTION);
+
+    return list->value;
+}
+
+void* il_get(const struct ImmutableList* list, size_t index) {
+    if(!list)
+        exit(EMPTY_LIST_EXCEPTION);
+
+    if(index >= list->length)
+        exit(INDEX_OUT_OF_RANGE_EXCEPTION);
+
+    for(; index > 0; --index)
+        list = list->next;
+
+    return list->value;
+}
+
+struct ImmutableList* il_pop_front(struct ImmutableList* list) {
+    if(!list)
+        exit(EMPTY_LIST_EXCEPTION);
+
+    return il_retain(list->next);
+}
+
+struct ImmutableList* il_push_front(struct ImmutableList* list, void* value) {
+    struct ImmutableList* node = (struct ImmutableList*) malloc(sizeof(struct ImmutableList));
+
+    if(!node)
+        exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+
+    node->references = 1;
+    node->length = il_size(list) + 1;
+    node->value = value;
+    node->next = il_retain(list);
+
+    return node;
+}
+
+void il_release(struct ImmutableList* list) {
+    // Iterative: releasing a long list must not overflow the stack
+    while(list && __atomic_sub_fetch(&list->references, 1, __ATOMIC_ACQ_REL) == 0) {
+        struct ImmutableList* next = list->next;
+
+        free(list->value);
+        free(list);
+        list = next;
+    }
+}
+
+struct ImmutableList* il_retain(struct ImmutableList* list) {
+    // The caller already holds a reference: nothing to synchronize with
+    if(list)
+        __atomic_add_fetch(&list->references, 1, __ATOMIC_RELAXED);
+
+    return list;
+}
+
+size_t il_size(const struct ImmutableList* list) {
+    return list ? list->length : 0;
+}
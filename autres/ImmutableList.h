@@ -0,0 +1,102 @@
+/*
+ * This file is a part of the C LinkedList library.
+ *
+ * File:   ImmutableList.h
+ * Author: Loïc FORTIN <loic.fortin@etud.univ-montp2.fr>
+ *
+ * Persistent singly linked list: a version is never modified.
+ *
+ * A list is its first node, NULL is the empty list. il_push_front and il_pop_front return
+ * a new version which shares all its nodes but one with the old one, so both stay usable.
+ * Each node counts the references to it (versions held by the caller and nodes pointing to it)
+ * with atomic operations, and is freed with its value when the last one is released.
+ *
+ * A snapshot is il_retain: O(1), no copy. The owner of a reference can hand a snapshot to
+ * another thread, which reads it without any lock and releases it when done.
+ *
+ * struct ImmutableList* v1 = il_push_front(NULL, value);
+ * struct ImmutableList* v2 = il_push_front(v1, other); // v1 is unchanged
+ * il_release(v1);
+ * il_release(v2);
+ */
+
+#ifndef IMMUTABLELIST_H
+#define IMMUTABLELIST_H
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#include "LinkedList.h" // Exception codes
+
+/*
+ * A node of the list, and the version of the list starting at it.
+ */
+struct ImmutableList {
+    size_t references; // Updated with atomic operations only
+    size_t length; // Length of the list starting at this node
+    void* value;
+    struct ImmutableList* next;
+};
+
+/*
+ * Returns the value of the first element.
+ *
+ * @param list A version of the list.
+ */
+void* il_first(const struct ImmutableList* list);
+
+/*
+ * Returns the value of the element at position index.
+ *
+ * @param list A version of the list.
+ * @param index Position of an element in the list.
+ */
+void* il_get(const struct ImmutableList* list, size_t index);
+
+/*
+ * Returns the version without its first element. The caller owns a new reference on it
+ * and keeps its reference on list.
+ *
+ * @param list A non-empty version of the list.
+ */
+struct ImmutableList* il_pop_front(struct ImmutableList* list);
+
+/*
+ * Returns the version list with value in front. The caller owns a reference on it
+ * and keeps its reference on list. The list owns value and frees it with the node.
+ *
+ * @param list A version of the list, NULL for the empty list.
+ * @param value Value of the new element.
+ */
+struct ImmutableList* il_push_front(struct ImmutableList* list, void* value);
+
+/*
+ * Releases a reference on a version. The nodes which are no longer referenced are destroyed.
+ *
+ * @param list A version of the list, NULL for the empty list.
+ */
+void il_release(struct ImmutableList* list);
+
+/*
+ * Takes a new reference on a version: this is an O(1) snapshot.
+ *
+ * @param list A version of the list, NULL for the empty list.
+ *
+ * @return list
+ */
+struct ImmutableList* il_retain(struct ImmutableList* list);
+
+/*
+ * Returns the number of elements of a version.
+ *
+ * @param list A version of the list, NULL for the empty list.
+ */
+size_t il_size(const struct ImmutableList* list);
+
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  /* IMMUTABLELIST_H */
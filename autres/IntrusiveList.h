@@ -0,0 +1,143 @@
+/*
+ * This file is a part of the C LinkedList library.
+ *
+ * File:   IntrusiveList.h
+ * Author: Loïc FORTIN <loic.fortin@etud.univ-montp2.fr>
+ *
+ * Intrusive doubly linked list: the links are embedded in the user's structure
+ * instead of being allocated in a separate node, so inserting and removing
+ * never allocate and run in O(1), and traversal only touches the user's objects.
+ *
+ * struct Job {
+ *     int priority;
+ *     struct ll_link link;
+ * };
+ *
+ * struct ll_link jobs;
+ * ll_link_init(&jobs);
+ * ll_link_add_tail(&jobs, &job->link);
+ * ll_link_for_each(ite, &jobs) {
+ *     struct Job* job = ll_container_of(ite, struct Job, link);
+ * }
+ */
+
+#ifndef INTRUSIVELIST_H
+#define INTRUSIVELIST_H
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h> // offsetof
+#include <stdbool.h> // bool
+
+/*
+ * Links embedded in the user's structure.
+ * The list itself is an ll_link used as a sentinel: an empty list points to itself.
+ */
+struct ll_link {
+    struct ll_link* previous;
+    struct ll_link* next;
+};
+
+/*
+ * Returns a pointer to the structure of type type containing the ll_link ptr in its member member.
+ */
+#define ll_container_of(ptr, type, member) \
+    ((type*) ((char*) (ptr) - offsetof(type, member)))
+
+/*
+ * Iterates over the links of the list head. The current link must not be removed.
+ */
+#define ll_link_for_each(ite, head) \
+    for((ite) = (head)->next; (ite) != (head); (ite) = (ite)->next)
+
+/*
+ * Iterates over the links of the list head. The current link may be removed: tmp keeps the next one.
+ */
+#define ll_link_for_each_safe(ite, tmp, head) \
+    for((ite) = (head)->next, (tmp) = (ite)->next; (ite) != (head); (ite) = (tmp), (tmp) = (ite)->next)
+
+/*
+ * Initializes an empty list (or an unlinked element).
+ *
+ * @param head Pointer to the sentinel.
+ */
+static inline void ll_link_init(struct ll_link* head) {
+    head->previous = head;
+    head->next = head;
+}
+
+/*
+ * Returns true if the list contains no element.
+ *
+ * @param head Pointer to the sentinel.
+ */
+static inline bool ll_link_empty(const struct ll_link* head) {
+    return head->next == head;
+}
+
+/*
+ * Links element between two consecutive links.
+ */
+static inline void ll_link_between(struct ll_link* element, struct ll_link* previous, struct ll_link* next) {
+    element->previous = previous;
+    element->next = next;
+    previous->next = element;
+    next->previous = element;
+}
+
+/*
+ * Inserts element at the beginning of the list.
+ *
+ * @param head Pointer to the sentinel.
+ * @param element Links of the element to insert.
+ */
+static inline void ll_link_add(struct ll_link* head, struct ll_link* element) {
+    ll_link_between(element, head, head->next);
+}
+
+/*
+ * Inserts element at the end of the list.
+ *
+ * @param head Pointer to the sentinel.
+ * @param element Links of the element to insert.
+ */
+static inline void ll_link_add_tail(struct ll_link* head, struct ll_link* element) {
+    ll_link_between(element, head->previous, head);
+}
+
+/*
+ * Removes element from its list. The element is left unlinked (pointing to itself).
+ *
+ * @param element Links of the element to remove.
+ */
+static inline void ll_link_del(struct ll_link* element) {
+    element->previous->next = element->next;
+    element->next->previous = element->previous;
+    ll_link_init(element);
+}
+
+/*
+ * Moves all the elements of list at the end of head, leaving list empty.
+ *
+ * @param head Pointer to the destination sentinel.
+ * @param list Pointer to the source sentinel.
+ */
+static inline void ll_link_splice_tail(struct ll_link* head, struct ll_link* list) {
+    if(ll_link_empty(list))
+        return;
+
+    list->next->previous = head->previous;
+    head->previous->next = list->next;
+    list->previous->next = head;
+    head->previous = list->previous;
+    ll_link_init(list);
+}
+
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  /* INTRUSIVELIST_H */
@@ -0,0 +1,1168 @@
+/* 
+ * This file is a part of the C LinkedList library.
+ * 
+ * File:   LinkedList.c
+ * Author: Loïc FORTIN <loic.fortin@etud.univ-montp2.fr>
+ *
+ * Created on 6 octobre 2014, 07:41
+ */
+
+#define _POSIX_C_SOURCE 200809L // ssize_t, read, write
+
+#include "LinkedList.h"
+
+#include <errno.h>
+#include <sys/stat.h> // fstat
+#include <unistd.h> // read, write, lseek
+
+#include "../Instrumentation.h" // INSTR_* (empty unless BIBLISD_INSTRUMENTATION is defined)
+#include "../Recyclage.h" // Per-thread cache of list structures and node blocks
+#include "../Trace.h" // TRACE (empty unless BIBLISD_TRACE is defined)
+
+#define LL_BLOCK_MIN 8 // Minimum number of nodes allocated at once
+#define LL_BLOCK_MAX 1024 // Maximum number of nodes allocated at once for single insertions
+#define LL_IO_BUFFER_SIZE 65536
+#define LL_TEXT_BUFFER_SIZE 65536
+#define LL_STREAM_MAGIC "BSDL"
+#define LL_STREAM_VERSION 1
+#define LL_STREAM_LENGTH_PREFIXED 1
+
+/*
+ * Value of a node killed by ll_kill: its address cannot be the value of a live node.
+ */
+static char ll_tombstone;
+#define LL_DEAD ((void*) &ll_tombstone)
+
+/*
+ * Starts loading the node after next, and the value of the next one, while the current
+ * node is processed. Loading next->next does not depend on the current value, so a
+ * scan of nodes scattered in memory keeps two misses in flight instead of one.
+ */
+static inline void ll_prefetch_ahead(const struct Node* node) {
+    const struct Node* next = node->next;
+    
+    if(next) {
+        __builtin_prefetch(next->next);
+        __builtin_prefetch(next->value);
+    }
+}
+
+/*
+ * Header of the binary format used by ll_write and ll_read.
+ */
+struct ll_stream_header {
+    char magic[4];
+    uint16_t version;
+    uint16_t flags; // LL_STREAM_LENGTH_PREFIXED or 0
+    uint32_t value_size; // 0 for length-prefixed records
+    uint32_t reserved;
+    uint64_t length;
+};
+
+/*
+ * Block of nodes allocated at once.
+ */
+struct ll_block {
+    struct ll_block* next; // Next block owned by the same list
+    size_t size; // Size of the block in bytes, to give it back to the cache
+    struct Node nodes[]; // The nodes
+};
+
+/*
+ * Takes a block of at least *count nodes from the cache and gives it to the list.
+ * *count is set to the number of nodes that fit in the block.
+ */
+static struct Node* ll_add_block(struct LinkedList* list, size_t* count) {
+    size_t size = Recyclage_taille(sizeof(struct ll_block) + *count * sizeof(struct Node));
+    struct ll_block* block = (struct ll_block*) Recyclage_prendre(size);
+    
+    if(!block)
+        exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+    
+    INSTR_COMPTER(INSTR_LISTE, allocations, 1);
+    
+    block->size = size;
+    *count = (size - sizeof(struct ll_block)) / sizeof(struct Node);
+    block->next = list->blocks;
+    list->blocks = block;
+    
+    return block->nodes;
+}
+
+/*
+ * Returns an unlinked node, reusing a removed one when possible.
+ * Otherwise a new block is allocated, larger as the list grows.
+ */
+static struct Node* ll_node_alloc(struct LinkedList* list) {
+    if(!list->free_nodes) {
+        size_t count = list->length;
+        
+        if(count < LL_BLOCK_MIN)
+            count = LL_BLOCK_MIN;
+        if(count > LL_BLOCK_MAX)
+            count = LL_BLOCK_MAX;
+        
+        struct Node* nodes = ll_add_block(list, &count);
+        
+        for(size_t i = 0; i < count; ++i) {
+            nodes[i].next = list->free_nodes;
+            list->free_nodes = &nodes[i];
+        }
+    }
+    
+    struct Node* node = list->free_nodes;
+    list->free_nodes = node->next;
+    
+    return node;
+}
+
+/*
+ * Returns true if node is one of the nodes stored inside the list structure.
+ */
+static bool ll_is_small_node(struct LinkedList* list, struct Node* node) {
+    return (uintptr_t) node >= (uintptr_t) list->small_nodes
+        && (uintptr_t) node < (uintptr_t) (list->small_nodes + LL_SMALL_NODES);
+}
+
+/*
+ * Makes the free nodes the nodes stored inside the list structure. No node may be linked anymore.
+ */
+static void ll_reset_small_nodes(struct LinkedList* list) {
+    list->free_nodes = NULL;
+    
+    for(size_t i = LL_SMALL_NODES; i-- > 0; ) {
+        list->small_nodes[i].next = list->free_nodes;
+        list->free_nodes = &list->small_nodes[i];
+    }
+}
+
+/*
+ * Frees all the blocks of the list. No node may be linked anymore.
+ */
+static void ll_release_blocks(struct LinkedList* list) {
+    while(list->blocks) {
+        struct ll_block* next = list->blocks->next;
+        Recyclage_rendre(list->blocks, list->blocks->size);
+        list->blocks = next;
+    }
+    
+    ll_reset_small_nodes(list);
+}
+
+/*
+ * Moves the blocks and free nodes of other to list (used when list takes the nodes of other).
+ * The nodes stored inside other must not be linked anymore: they stay in other.
+ */
+static void ll_adopt_blocks(struct LinkedList* list, struct LinkedList* other) {
+    if(other->blocks) {
+        struct ll_block* last = other->blocks;
+        
+        while(last->next)
+            last = last->next;
+        
+        last->next = list->blocks;
+        list->blocks = other->blocks;
+        other->blocks = NULL;
+    }
+    
+    while(other->free_nodes) {
+        struct Node* node = other->free_nodes;
+        other->free_nodes = node->next;
+        
+        if(!ll_is_small_node(other, node)) {
+            node->next = list->free_nodes;
+            list->free_nodes = node;
+        }
+    }
+    
+    ll_reset_small_nodes(other);
+}
+
+/*
+ * Compacts the list once the killed elements reach the compaction threshold. Below it, the
+ * indexed operations skip them instead, so a few tombstones never cost an O(n) pass each.
+ */
+static void ll_compact_if_needed(struct LinkedList* list) {
+    if(list->dead > 0 && list->dead >= list->compaction_threshold * list->length)
+        ll_compact(list);
+}
+
+/*
+ * Returns the node of the live element at position index, skipping the killed ones and
+ * walking from the nearest end. index must be lower than ll_size(list).
+ */
+static struct Node* ll_live_node(struct LinkedList* list, size_t index) {
+    size_t size = ll_size(list);
+    size_t steps = 0;
+    struct Node* ite;
+    
+    if(index < size / 2) {
+        ite = list->first;
+        
+        while(ite->value == LL_DEAD || index-- > 0) {
+            ite = ite->next;
+            ++steps;
+        }
+    }
+    else {
+        index = size - 1 - index;
+        ite = list->last;
+        
+        while(ite->value == LL_DEAD || index-- > 0) {
+            ite = ite->previous;
+            ++steps;
+        }
+    }
+    
+    INSTR_COMPTER(INSTR_LISTE, pas_parcours, steps);
+    
+    return ite;
+}
+
+/*
+ * Returns the live element at position index - 1 (NULL for index 0).
+ */
+static struct Node* ll_node_before(struct LinkedList* list, size_t index) {
+    return (index == 0) ? NULL : ll_live_node(list, index - 1);
+}
+
+/*
+ * Links n new nodes at position index and returns the first one.
+ * Large ranges are allocated in one block. The values of the new nodes are left to the caller.
+ */
+static struct Node* ll_link_range(struct LinkedList* list, size_t index, size_t n) {
+    size_t count = n;
+    struct Node* block = (n > LL_SMALL_NODES) ? ll_add_block(list, &count) : NULL;
+    
+    // The end of the block that is not needed goes to the free nodes
+    for(size_t i = n; block && i < count; ++i) {
+        block[i].next = list->free_nodes;
+        list->free_nodes = &block[i];
+    }
+    
+    struct Node* previous = ll_node_before(list, index);
+    struct Node* next = previous ? previous->next : list->first;
+    struct Node* tail = previous;
+    
+    // Chain the new nodes after previous
+    for(size_t i = 0; i < n; ++i) {
+        struct Node* node = block ? &block[i] : ll_node_alloc(list);
+        
+        node->previous = tail;
+        
+        if(tail)
+            tail->next = node;
+        else
+            list->first = node;
+        
+        tail = node;
+    }
+    
+    // Then to the rest of the list
+    tail->next = next;
+    
+    if(next)
+        next->previous = tail;
+    else
+        list->last = tail;
+    
+    list->length += n;
+    
+    return previous ? previous->next : list->first;
+}
+
+void ll_clear(struct LinkedList* list) {
+    // Free the values, then all the nodes at once
+    for(struct Node* ite = list->first; ite; ite = ite->next) {
+        if(ite->value != LL_DEAD)
+            free(ite->value);
+    }
+    
+    list->first = NULL;
+    list->last = NULL;
+    list->length = 0;
+    list->dead = 0;
+    
+    ll_release_blocks(list);
+}
+
+struct LinkedList* ll_clone(struct LinkedList* list) {
+    INSTR_DEBUT(start);
+    struct LinkedList* tmp = ll_create();
+    struct Node* ite = list->first;
+    
+    tmp->value_size = list->value_size;
+    
+    // All the nodes of the copy are allocated in one block
+    struct Node* copy = ll_empty(list) ? NULL : ll_link_range(tmp, 0, ll_size(list));
+    
+    // Iterate until the end of the list
+    while(ite) {
+        // Killed elements are not copied
+        if(ite->value == LL_DEAD) {
+            ite = ite->next;
+            continue;
+        }
+        
+        /*
+         * We must allocate a new block of memory to copy the value.
+         * ite->value is a void*. We are allocating 1*sizeof(ite->value) so we don't need a
+         * void** but a simple void* (in this case, using void** is not necessary because 
+         * malloc return a pointer to a single block of memory, which is equivalent to a table 
+         * with only one line).
+         */
+        void* value = (void*) malloc(list->value_size);
+        
+        if(!value)
+            exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+        
+        INSTR_COMPTER(INSTR_LISTE, allocations, 1);
+        INSTR_COMPTER(INSTR_LISTE, octets_deplaces, list->value_size);
+        memcpy(value, ite->value, list->value_size);
+        copy->value = value;
+        copy = copy->next;
+        ite = ite->next;
+        
+        if(ite == list->first) {
+            exit(CIRCULAR_REFERENCE_EXCEPTION);
+        }
+    }
+    
+    INSTR_FIN(INSTR_LISTE, INSTR_COPIE, start);
+    TRACE(TRACE_LISTE_CLONER, tmp, (uintptr_t)list);
+    
+    return tmp;
+}
+
+void ll_compact(struct LinkedList* list) {
+    if(list->dead == 0)
+        return;
+    
+    struct Node* ite = list->first;
+    
+    INSTR_COMPTER(INSTR_LISTE, pas_parcours, list->length);
+    
+    while(ite) {
+        struct Node* next = ite->next;
+        
+        if(ite->value == LL_DEAD)
+            ll_remove_node(list, ite);
+        
+        ite = next;
+    }
+}
+
+bool ll_contains(struct LinkedList* list, void* value) {
+    if(ll_empty(list))
+        return false;
+    
+    INSTR_DEBUT(start);
+    struct Node* ite = list->first;
+    size_t steps = 0;
+    size_t comparisons = 0;
+    
+    // Iterate until we reach the value, skipping the killed elements
+    while(ite) {
+        ll_prefetch_ahead(ite);
+        
+        if(ite->value != LL_DEAD) {
+            ++comparisons;
+            
+            if(memcmp(ite->value, value, list->value_size) == 0)
+                break;
+        }
+        
+        ite = ite->next;
+        ++steps;
+        
+        if(ite == list->first) {
+            exit(CIRCULAR_REFERENCE_EXCEPTION);
+        }
+    }
+    
+    bool found = (ite ? true : false);
+    
+    INSTR_COMPTER(INSTR_LISTE, pas_parcours, steps);
+    INSTR_COMPTER(INSTR_LISTE, comparaisons, comparisons);
+    INSTR_FIN(INSTR_LISTE, INSTR_RECHERCHE, start);
+    
+    return found;
+}
+
+struct LinkedList* ll_create() {
+    struct LinkedList* list = (struct LinkedList*) Recyclage_prendre(sizeof(struct LinkedList));
+    
+    if(!list)
+        exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+    
+    INSTR_COMPTER(INSTR_LISTE, allocations, 1);
+    
+    ll_init(list);
+    TRACE(TRACE_LISTE_CREER, list, 0);
+    
+    return list;
+}
+
+size_t ll_dead_count(struct LinkedList* list) {
+    return list->dead;
+}
+
+void ll_destroy(struct LinkedList* list) {
+    TRACE(TRACE_LISTE_DETRUIRE, list, 0);
+    ll_fini(list);
+    Recyclage_rendre(list, sizeof(struct LinkedList));
+}
+
+/*
+ * write() until everything is written, resuming after partial writes.
+ */
+static int ll_write_all(int fd, const char* data, size_t n) {
+    while(n > 0) {
+        ssize_t k = write(fd, data, n);
+        
+        if(k < 0) {
+            if(errno == EINTR)
+                continue;
+            return -1;
+        }
+        
+        data += k;
+        n -= (size_t) k;
+    }
+    
+    return 0;
+}
+
+int ll_dump(struct LinkedList* list, int fd, ll_formatter formatter) {
+    char buffer[LL_TEXT_BUFFER_SIZE];
+    size_t used = 0;
+    
+    for(struct Node* ite = list->first; ite; ite = ite->next) {
+        ll_prefetch_ahead(ite);
+        
+        if(ite->value == LL_DEAD)
+            continue;
+        
+        // Send the chunk when the next value, its separator and the final newline may not fit
+        if(used + LL_FORMAT_MAX + 2 > LL_TEXT_BUFFER_SIZE) {
+            if(ll_write_all(fd, buffer, used) != 0)
+                return -1;
+            used = 0;
+        }
+        
+        used += formatter(buffer + used, ite->value);
+        buffer[used++] = ' ';
+    }
+    
+    buffer[used++] = '\n';
+    
+    return ll_write_all(fd, buffer, used);
+}
+
+size_t ll_dump_buffer(struct LinkedList* list, char* dest, size_t size, ll_formatter formatter) {
+    char tmp[LL_FORMAT_MAX + 1];
+    size_t total = 0;
+    struct Node* ite = list->first;
+    
+    while(true) {
+        size_t k;
+        
+        if(ite && ite->value == LL_DEAD) {
+            ite = ite->next;
+            continue;
+        }
+        
+        if(!ite) {
+            tmp[0] = '\n';
+            k = 1;
+        }
+        else if(total + LL_FORMAT_MAX + 1 < size) {
+            // Enough room left: format directly into dest
+            k = formatter(dest + total, ite->value);
+            dest[total + k] = ' ';
+            total += k + 1;
+            ite = ite->next;
+            continue;
+        }
+        else {
+            k = formatter(tmp, ite->value);
+            tmp[k++] = ' ';
+        }
+        
+        if(total < size)
+            memcpy(dest + total, tmp, (total + k < size) ? k : size - total);
+        
+        total += k;
+        
+        if(!ite)
+            break;
+        
+        ite = ite->next;
+    }
+    
+    if(size > 0)
+        dest[(total < size) ? total : size - 1] = '\0';
+    
+    return total;
+}
+
+bool ll_empty(struct LinkedList* list) {
+    return ((ll_size(list) == 0) ? true : false);
+}
+
+/*
+ * Unlinks the killed elements at both ends of the list, so that first and last are alive.
+ */
+static void ll_purge_ends(struct LinkedList* list) {
+    while(list->dead && list->first && list->first->value == LL_DEAD)
+        ll_remove_node(list, list->first);
+    
+    while(list->dead && list->last && list->last->value == LL_DEAD)
+        ll_remove_node(list, list->last);
+}
+
+void ll_fini(struct LinkedList* list) {
+    ll_clear(list);
+}
+
+void* ll_first(struct LinkedList* list) {
+    ll_purge_ends(list);
+    
+    if(ll_empty(list))
+        exit(EMPTY_LIST_EXCEPTION);
+    
+    return list->first->value;
+}
+
+size_t ll_format_int(char* buffer, const void* value) {
+    static const char digits[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    int x = *((const int*) value);
+    unsigned int u = (x < 0) ? 0u - (unsigned int) x : (unsigned int) x;
+    char tmp[12];
+    size_t n = sizeof(tmp);
+    size_t k = 0;
+    
+    // Two digits at a time, from right to left
+    while(u >= 100) {
+        unsigned int d = (u % 100) * 2;
+        u /= 100;
+        tmp[--n] = digits[d + 1];
+        tmp[--n] = digits[d];
+    }
+    
+    if(u >= 10) {
+        tmp[--n] = digits[u * 2 + 1];
+        tmp[--n] = digits[u * 2];
+    }
+    else {
+        tmp[--n] = (char) ('0' + u);
+    }
+    
+    if(x < 0)
+        buffer[k++] = '-';
+    
+    memcpy(buffer + k, tmp + n, sizeof(tmp) - n);
+    
+    return k + sizeof(tmp) - n;
+}
+
+void* ll_get(struct LinkedList* list, size_t index) {
+    ll_compact_if_needed(list);
+    
+    if(ll_empty(list))
+        exit(EMPTY_LIST_EXCEPTION);
+    
+    //if(index < 0 || index >= list->length)
+    if(index >= ll_size(list))
+        exit(INDEX_OUT_OF_RANGE_EXCEPTION);
+    
+    INSTR_DEBUT(start);
+    struct Node* ite = ll_live_node(list, index);
+    
+    INSTR_FIN(INSTR_LISTE, INSTR_ACCES, start);
+    TRACE(TRACE_LISTE_ACCEDER, list, index);
+    
+    return ite->value;
+}
+
+void ll_init(struct LinkedList* list) {
+    list->first = NULL;
+    list->last = NULL;
+    list->length = 0;
+    list->blocks = NULL;
+    list->dead = 0;
+    list->compaction_threshold = LL_COMPACTION_THRESHOLD;
+    list->value_size = LL_VALUE_SIZE;
+    ll_reset_small_nodes(list);
+}
+
+void ll_insert(struct LinkedList* list, size_t index, void* value, size_t n) {
+    if(n < 1)
+        exit(NUMBER_INSERTION_EXCEPTION);
+    
+    ll_compact_if_needed(list);
+    
+    // The position must be an element of the list, or 0 if the list is empty
+    //if(index < 0 || index >= list->length)
+    if(index >= ll_size(list) && !(ll_empty(list) && index == 0))
+        exit(INDEX_OUT_OF_RANGE_EXCEPTION);
+    
+    INSTR_DEBUT(start);
+    struct Node* ite = ll_link_range(list, index, n);
+    
+    ite->value = value;
+    
+    // The other elements get their own copy of value (like ll_clone), so that each one can be freed
+    for(size_t k = 1; k < n; ++k) {
+        ite = ite->next;
+        ite->value = malloc(list->value_size);
+        
+        if(!ite->value)
+            exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+        
+        memcpy(ite->value, value, list->value_size);
+    }
+    
+    INSTR_FIN(INSTR_LISTE, INSTR_INSERTION, start);
+    
+    // n insertions of one element at index give the same list
+    for(size_t k = 0; k < n; ++k)
+        TRACE(TRACE_LISTE_INSERER, list, index);
+}
+
+struct Node* ll_insert_after(struct LinkedList* list, struct Node* node, void* value) {
+    struct Node* tmp = ll_node_alloc(list);
+    
+    tmp->value = value;
+    tmp->previous = node;
+    tmp->next = node ? node->next : list->first;
+    
+    if(node)
+        node->next = tmp;
+    else
+        list->first = tmp;
+    
+    if(tmp->next)
+        (tmp->next)->previous = tmp;
+    else
+        list->last = tmp;
+    
+    ++list->length;
+    
+    return tmp;
+}
+
+void ll_insert_range(struct LinkedList* list, size_t index, void** values, size_t n) {
+    ll_compact_if_needed(list);
+    
+    if(index > ll_size(list))
+        exit(INDEX_OUT_OF_RANGE_EXCEPTION);
+    
+    if(n == 0)
+        return;
+    
+    INSTR_DEBUT(start);
+    struct Node* ite = ll_link_range(list, index, n);
+    
+    for(size_t k = 0; k < n; ++k, ite = ite->next)
+        ite->value = values[k];
+    
+    INSTR_FIN(INSTR_LISTE, INSTR_INSERTION, start);
+    
+    for(size_t k = 0; k < n; ++k)
+        TRACE(TRACE_LISTE_INSERER, list, index + k);
+}
+
+void ll_kill(struct LinkedList* list, struct Node* node) {
+    if(node->value == LL_DEAD)
+        return;
+    
+    free(node->value);
+    node->value = LL_DEAD;
+    ++list->dead;
+    
+    ll_compact_if_needed(list);
+}
+
+void* ll_last(struct LinkedList* list) {
+    ll_purge_ends(list);
+    
+    if(ll_empty(list))
+        exit(EMPTY_LIST_EXCEPTION);
+    
+    return list->last->value;
+}
+
+/*
+ * Merges the two sorted chains a and b (linked by next only) and returns the first node.
+ * *tail receives the last node. Equivalent values of a come first, which keeps the sort stable.
+ * Killed nodes are taken as soon as they are met and never given to compare.
+ */
+static struct Node* ll_merge_chains(struct Node* a, struct Node* b, ll_compare compare, struct Node** tail) {
+    struct Node head;
+    struct Node* last = &head;
+    
+    while(a && b) {
+        if(a->value != LL_DEAD && (b->value == LL_DEAD || compare(b->value, a->value) < 0)) {
+            last->next = b;
+            b = b->next;
+        }
+        else {
+            last->next = a;
+            a = a->next;
+        }
+        
+        last = last->next;
+    }
+    
+    last->next = a ? a : b;
+    
+    while(last->next)
+        last = last->next;
+    
+    *tail = last;
+    
+    return head.next;
+}
+
+/*
+ * Rebuilds the previous pointers and the last element from the next pointers.
+ */
+static void ll_relink_previous(struct LinkedList* list) {
+    struct Node* previous = NULL;
+    
+    for(struct Node* ite = list->first; ite; ite = ite->next) {
+        ite->previous = previous;
+        previous = ite;
+    }
+    
+    list->last = previous;
+}
+
+void ll_merge(struct LinkedList* list, struct LinkedList* other, ll_compare compare) {
+    struct Node* tail;
+    
+    if(other == list || ll_empty(other))
+        return;
+    
+    ll_compact_if_needed(list);
+    ll_compact_if_needed(other);
+    
+    // The nodes stored inside other are replaced by nodes of list
+    for(struct Node* ite = other->first; ite; ite = ite->next) {
+        if(ll_is_small_node(other, ite)) {
+            struct Node* node = ll_node_alloc(list);
+            
+            *node = *ite;
+            
+            if(node->previous)
+                node->previous->next = node;
+            else
+                other->first = node;
+            
+            if(node->next)
+                node->next->previous = node;
+            else
+                other->last = node;
+            
+            ite = node;
+        }
+    }
+    
+    list->first = ll_merge_chains(list->first, other->first, compare, &tail);
+    list->length += other->length;
+    list->dead += other->dead;
+    ll_relink_previous(list);
+    ll_adopt_blocks(list, other);
+    
+    other->first = NULL;
+    other->last = NULL;
+    other->length = 0;
+    other->dead = 0;
+}
+
+/*
+ * Unlinks a node and recycles it, without touching its value.
+ */
+static void ll_unlink_node(struct LinkedList* list, struct Node* tmp) {
+    if(tmp->previous != NULL) {
+        (tmp->previous)->next = tmp->next;
+    }
+    else {
+        list->first = tmp->next;
+    }
+    
+    if(tmp->next != NULL) {
+        (tmp->next)->previous = tmp->previous;
+    }
+    else {
+        list->last = tmp->previous;
+    }
+    
+    tmp->previous = NULL;
+    tmp->next = list->free_nodes;
+    list->free_nodes = tmp;
+    
+    --list->length;
+}
+
+void* ll_pop_back(struct LinkedList* list) {
+    void* value = ll_last(list);
+    
+    ll_unlink_node(list, list->last);
+    TRACE(TRACE_LISTE_RETIRER_FIN, list, 0);
+    
+    return value;
+}
+
+void* ll_pop_front(struct LinkedList* list) {
+    void* value = ll_first(list);
+    
+    ll_unlink_node(list, list->first);
+    TRACE(TRACE_LISTE_RETIRER_TETE, list, 0);
+    
+    return value;
+}
+
+void ll_push_back(struct LinkedList* list, void* value) {
+    ll_insert_after(list, list->last, value);
+    TRACE(TRACE_LISTE_AJOUTER_FIN, list, 0);
+}
+
+void ll_push_front(struct LinkedList* list, void* value) {
+    
+    ll_insert(list, 0, value, 1);
+}
+
+/*
+ * Buffered reader used by ll_read.
+ */
+struct ll_reader {
+    int fd;
+    size_t pos;
+    size_t end;
+    char buffer[LL_IO_BUFFER_SIZE];
+};
+
+/*
+ * Copies the next n bytes of the stream to dst, refilling the buffer as needed.
+ * Returns -1 if the stream ends first.
+ */
+static int ll_reader_take(struct ll_reader* reader, void* dst, size_t n) {
+    char* out = (char*) dst;
+    
+    while(n > 0) {
+        if(reader->pos == reader->end) {
+            ssize_t k = read(reader->fd, reader->buffer, LL_IO_BUFFER_SIZE);
+            
+            if(k < 0 && errno == EINTR)
+                continue;
+            if(k <= 0)
+                return -1;
+            
+            reader->pos = 0;
+            reader->end = (size_t) k;
+        }
+        
+        size_t chunk = reader->end - reader->pos;
+        if(chunk > n)
+            chunk = n;
+        
+        memcpy(out, reader->buffer + reader->pos, chunk);
+        reader->pos += chunk;
+        out += chunk;
+        n -= chunk;
+    }
+    
+    return 0;
+}
+
+/*
+ * Returns the number of bytes left in the stream, buffered ones included,
+ * or UINT64_MAX when the file descriptor is not a regular file.
+ */
+static uint64_t ll_reader_left(struct ll_reader* reader) {
+    struct stat st;
+    off_t offset;
+    
+    if(fstat(reader->fd, &st) != 0 || !S_ISREG(st.st_mode) || (offset = lseek(reader->fd, 0, SEEK_CUR)) < 0)
+        return UINT64_MAX;
+    
+    return (uint64_t) (st.st_size > offset ? st.st_size - offset : 0) + (reader->end - reader->pos);
+}
+
+struct LinkedList* ll_read(int fd) {
+    struct ll_reader* reader = (struct ll_reader*) malloc(sizeof(struct ll_reader));
+    
+    if(!reader)
+        exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+    
+    reader->fd = fd;
+    reader->pos = 0;
+    reader->end = 0;
+    
+    struct ll_stream_header header;
+    
+    if(ll_reader_take(reader, &header, sizeof(header)) != 0
+            || memcmp(header.magic, LL_STREAM_MAGIC, 4) != 0
+            || header.version != LL_STREAM_VERSION) {
+        free(reader);
+        return NULL;
+    }
+    
+    bool prefixed = (header.flags & LL_STREAM_LENGTH_PREFIXED) != 0;
+    uint64_t left = ll_reader_left(reader);
+    uint64_t record_min = prefixed ? sizeof(uint32_t) : header.value_size;
+    
+    // Each record takes at least record_min bytes: a longer list cannot be in the stream
+    if(header.length > 0 && (record_min == 0 || header.length > left / record_min)) {
+        free(reader);
+        return NULL;
+    }
+    
+    struct LinkedList* list = ll_create();
+    
+    for(uint64_t i = 0; i < header.length; ++i) {
+        uint32_t size = header.value_size;
+        
+        if(prefixed) {
+            if(ll_reader_take(reader, &size, sizeof(size)) != 0)
+                break;
+            left -= sizeof(size);
+        }
+        
+        // A record larger than the rest of the stream is corrupted
+        if(size > left)
+            break;
+        
+        left -= size;
+        
+        // Always allocate at least one byte so that an empty value is not NULL
+        void* value = malloc(size ? size : 1);
+        
+        if(!value)
+            break;
+        
+        INSTR_COMPTER(INSTR_LISTE, allocations, 1);
+        
+        if(ll_reader_take(reader, value, size) != 0) {
+            free(value);
+            break;
+        }
+        
+        ll_insert_after(list, list->last, value);
+    }
+    
+    free(reader);
+    
+    // Truncated stream, oversized record or not enough memory
+    if(list->length != header.length) {
+        ll_destroy(list);
+        return NULL;
+    }
+    
+    return list;
+}
+
+void ll_release(struct LinkedList* list) {
+    list->first = NULL;
+    list->last = NULL;
+    list->length = 0;
+    list->dead = 0;
+    
+    ll_release_blocks(list);
+}
+
+void ll_remove(struct LinkedList* list) {
+    ll_remove_at(list, 0);
+}
+
+void ll_remove_at(struct LinkedList* list, size_t index) {
+    ll_compact_if_needed(list);
+    
+    if(ll_empty(list))
+        exit(EMPTY_LIST_EXCEPTION);
+    
+    //if(index < 0 || index >= list->length)
+    if(index >= ll_size(list))
+        exit(INDEX_OUT_OF_RANGE_EXCEPTION);
+    
+    INSTR_DEBUT(start);
+    struct Node* tmp = ll_live_node(list, index);
+    
+    ll_remove_node(list, tmp);
+    
+    INSTR_FIN(INSTR_LISTE, INSTR_SUPPRESSION, start);
+    TRACE(TRACE_LISTE_RETIRER, list, index);
+}
+
+void ll_remove_node(struct LinkedList* list, struct Node* tmp) {
+    if(tmp->value == LL_DEAD)
+        --list->dead;
+    else
+        free(tmp->value);
+    
+    ll_unlink_node(list, tmp);
+}
+
+void ll_reset(struct LinkedList* list) {
+    // Free the values, then give all the nodes to free_nodes
+    for(struct Node* ite = list->first; ite; ite = ite->next) {
+        if(ite->value != LL_DEAD)
+            free(ite->value);
+    }
+    
+    if(list->first) {
+        list->last->next = list->free_nodes;
+        list->free_nodes = list->first;
+    }
+    
+    list->first = NULL;
+    list->last = NULL;
+    list->length = 0;
+    list->dead = 0;
+    
+    TRACE(TRACE_LISTE_VIDER, list, 0);
+}
+
+void ll_set_compaction_threshold(struct LinkedList* list, double threshold) {
+    list->compaction_threshold = threshold;
+}
+
+void ll_set_value_size(struct LinkedList* list, size_t value_size) {
+    list->value_size = value_size;
+}
+
+size_t ll_size(struct LinkedList* list) {
+    return list->length - list->dead;
+}
+
+/*
+ * Cuts the chain after n nodes and returns the rest.
+ */
+static struct Node* ll_split(struct Node* ite, size_t n) {
+    for(size_t i = 1; ite && i < n; ++i)
+        ite = ite->next;
+    
+    if(!ite)
+        return NULL;
+    
+    struct Node* rest = ite->next;
+    ite->next = NULL;
+    
+    return rest;
+}
+
+void ll_sort(struct LinkedList* list, ll_compare compare) {
+    ll_compact_if_needed(list);
+    
+    if(list->length < 2)
+        return;
+    
+    // Merge runs of width 1, 2, 4, ... until a single run remains
+    for(size_t width = 1; width < list->length; width *= 2) {
+        struct Node head;
+        struct Node* tail = &head;
+        struct Node* rest = list->first;
+        
+        while(rest) {
+            struct Node* a = rest;
+            struct Node* b = ll_split(a, width);
+            rest = ll_split(b, width);
+            
+            struct Node* last;
+            tail->next = ll_merge_chains(a, b, compare, &last);
+            tail = last;
+        }
+        
+        list->first = head.next;
+    }
+    
+    ll_relink_previous(list);
+}
+
+void ll_swap(struct LinkedList* list, size_t x, size_t y) {
+    ll_compact_if_needed(list);
+    
+    if(ll_empty(list))
+        exit(EMPTY_LIST_EXCEPTION);
+    
+    //if(x < 0 || x >= list->length)
+    if(x >= ll_size(list))
+        exit(INDEX_OUT_OF_RANGE_EXCEPTION);
+    
+    //if(y < 0 || y >= list->length)
+    if(y >= ll_size(list))
+        exit(INDEX_OUT_OF_RANGE_EXCEPTION);
+    
+    struct Node* xtmp = ll_live_node(list, x);
+    struct Node* ytmp = ll_live_node(list, y);
+    
+    void* vtmp = xtmp->value;
+    xtmp->value = ytmp->value;
+    ytmp->value = vtmp;
+}
+
+int ll_write(struct LinkedList* list, int fd, size_t value_size, size_t (*value_length)(const void* value)) {
+    char* buffer = (char*) malloc(LL_IO_BUFFER_SIZE);
+    
+    if(!buffer)
+        exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+    
+    struct ll_stream_header header;
+    
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LL_STREAM_MAGIC, 4);
+    header.version = LL_STREAM_VERSION;
+    header.flags = value_length ? LL_STREAM_LENGTH_PREFIXED : 0;
+    header.value_size = value_length ? 0 : (uint32_t) value_size;
+    header.length = ll_size(list);
+    
+    memcpy(buffer, &header, sizeof(header));
+    size_t used = sizeof(header);
+    int status = 0;
+    
+    for(struct Node* ite = list->first; ite && status == 0; ite = ite->next) {
+        ll_prefetch_ahead(ite);
+        
+        if(ite->value == LL_DEAD)
+            continue;
+        
+        uint32_t size = (uint32_t) (value_length ? value_length(ite->value) : value_size);
+        size_t needed = size + (value_length ? sizeof(size) : 0);
+        
+        // Flush the buffer when the record does not fit
+        if(used + needed > LL_IO_BUFFER_SIZE) {
+            status = ll_write_all(fd, buffer, used);
+            used = 0;
+        }
+        
+        if(value_length) {
+            memcpy(buffer + used, &size, sizeof(size));
+            used += sizeof(size);
+        }
+        
+        // Records larger than the buffer are written directly
+        if(size > LL_IO_BUFFER_SIZE - used) {
+            if(status == 0)
+                status = ll_write_all(fd, buffer, used);
+            if(status == 0)
+                status = ll_write_all(fd, (const char*) ite->value, size);
+            used = 0;
+        }
+        else {
+            memcpy(buffer + used, ite->value, size);
+            used += size;
+        }
+    }
+    
+    if(status == 0)
+        status = ll_write_all(fd, buffer, used);
+    
+    free(buffer);
+    
+    return status;
+}
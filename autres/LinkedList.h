@@ -0,0 +1,464 @@
+/* 
+ * This file is a part of the C LinkedList library.
+ * 
+ * File:   LinkedList.h
+ * Author: Loïc FORTIN <loic.fortin@etud.univ-montp2.fr>
+ *
+ * Created on 3 octobre 2014, 09:08
+ */
+
+#ifndef LINKEDLIST_H
+#define LINKEDLIST_H
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdbool.h> // bool
+#include <string.h> // memcpy, memcmp
+#include <stdint.h> // uint32_t, uint64_t
+
+#define EMPTY_LIST_EXCEPTION 10
+#define INDEX_OUT_OF_RANGE_EXCEPTION 11
+#define NUMBER_INSERTION_EXCEPTION 12
+#define MEMORY_ALLOCATION_FAIL_EXCEPTION 13
+#define CIRCULAR_REFERENCE_EXCEPTION 14
+
+#define LL_FORMAT_MAX 64 // Maximum number of bytes written by a formatter for one value
+#define LL_SMALL_NODES 8 // Number of nodes stored inside the LinkedList structure itself
+#define LL_COMPACTION_THRESHOLD 0.25 // Default fraction of killed elements that triggers ll_compact
+#define LL_VALUE_SIZE sizeof(void*) // Default size of the values, see ll_set_value_size
+
+/*
+ * Writes the text of a value to buffer (at most LL_FORMAT_MAX bytes, no terminating '\0')
+ * and returns the number of bytes written.
+ */
+typedef size_t (*ll_formatter)(char* buffer, const void* value);
+
+/*
+ * Compares two values of the list: returns a negative number if a comes before b,
+ * 0 if they are equivalent and a positive number otherwise.
+ */
+typedef int (*ll_compare)(const void* a, const void* b);
+
+/*
+ * This structure represent a single element (node) on the list.
+ * It stores the data and has a pointer to the previous and next element (node) of the list.
+ */
+struct Node {
+    void* value;
+    struct Node* previous;
+    struct Node* next;
+};
+
+/*
+ * Block of nodes allocated at once (defined in LinkedList.c).
+ */
+struct ll_block;
+
+/*
+ * This structure represent the doubly linked list.
+ * It stores the length of the list and has a pointer to the first and last element.
+ * 
+ * Nodes are allocated by blocks: a removed node goes to free_nodes and is reused by the next insertion.
+ * The blocks are released by ll_clear and ll_destroy (ll_reset keeps them), and taken from and
+ * given back to the per-thread cache of Recyclage.h. The first LL_SMALL_NODES nodes come from
+ * small_nodes, inside the structure, so a small list never calls malloc for its nodes; the
+ * structure must therefore not be copied by value.
+ * 
+ * Elements removed with ll_kill stay linked until the next compaction: code that walks the nodes
+ * itself (instead of using the ll_* functions) must call ll_compact first.
+ */
+struct LinkedList {
+    size_t length; // Number of linked nodes, killed ones included
+    struct Node* first; // Pointer to the last element of the list
+    struct Node* last; // Pointer to the last element of the list
+    struct Node* free_nodes; // Nodes ready to be reused, linked by next
+    struct ll_block* blocks; // Blocks of nodes owned by the list
+    size_t dead; // Number of killed nodes still linked
+    double compaction_threshold; // Fraction of killed nodes that triggers ll_compact
+    size_t value_size; // Bytes compared by ll_contains and copied by ll_clone and ll_insert
+    struct Node small_nodes[LL_SMALL_NODES]; // Nodes used before any block is allocated
+};
+
+/*
+ * Removes all elements from the list container (which are destroyed), and leaving the container with a size of 0.
+ * 
+ * @param list Pointer to the container.
+ */
+void ll_clear(struct LinkedList* list);
+
+/*
+ * Returns a copy of the LinkedList.
+ * 
+ * @param list Pointer to the container.
+ * 
+ * @return A copy of the list
+ */
+struct LinkedList* ll_clone(struct LinkedList* list);
+
+/*
+ * Unlinks all the elements killed by ll_kill, in one pass over the list.
+ * 
+ * @param list Pointer to the container.
+ */
+void ll_compact(struct LinkedList* list);
+
+/*
+ * Returns true if this list contains the specified element, false otherwise.
+ * 
+ * @param list Pointer to the container
+ * @param value The value to search for.
+ */
+bool ll_contains(struct LinkedList* list, void* value);
+
+/*
+ * Create a new list container.
+ * 
+ * @param list Pointer to the container.
+ * 
+ * @return A new LinkedList
+ */
+struct LinkedList* ll_create();
+
+/*
+ * Returns the number of elements killed by ll_kill and not yet compacted.
+ * 
+ * @param list Pointer to the container.
+ */
+size_t ll_dead_count(struct LinkedList* list);
+
+/*
+ * Destroy a list container
+ * 
+ * @param list Pointer to the container.
+ */
+void ll_destroy(struct LinkedList* list);
+
+/*
+ * Writes the list as text to a file descriptor.
+ * 
+ * Each value is followed by a space and the text ends with a newline. The text is built in a large
+ * buffer on the stack and sent with one write per chunk: no allocation and no printf per element.
+ * 
+ * @param list Pointer to the container.
+ * @param fd File descriptor to write to.
+ * @param formatter Writes the text of one value.
+ * 
+ * @return 0 on success, -1 on write error.
+ */
+int ll_dump(struct LinkedList* list, int fd, ll_formatter formatter);
+
+/*
+ * Writes the same text as ll_dump to a memory buffer.
+ * 
+ * Like snprintf, the text is truncated to size-1 bytes and is always terminated by '\0'.
+ * 
+ * @param list Pointer to the container.
+ * @param dest Destination buffer.
+ * @param size Size of the destination buffer.
+ * @param formatter Writes the text of one value.
+ * 
+ * @return The length of the full text (without the '\0').
+ */
+size_t ll_dump_buffer(struct LinkedList* list, char* dest, size_t size, ll_formatter formatter);
+
+/*
+ * Returns whether the list container is empty (i.e. whether its size is 0).
+ * 
+ * @param list Pointer to the container.
+ * 
+ * @return true if the container size is 0, false otherwise.
+ */
+bool ll_empty(struct LinkedList* list);
+
+/*
+ * Destroys the values and frees the nodes of a list initialized by ll_init, but not the structure itself.
+ * The structure may be initialized again afterwards.
+ * 
+ * @param list Pointer to the container.
+ */
+void ll_fini(struct LinkedList* list);
+
+/*
+ * Returns the value of the first element in this list. 
+ * 
+ * @param list Pointer to the container.
+ * 
+ * @return The value of the first element in the list
+ */
+void* ll_first(struct LinkedList* list);
+
+/*
+ * Formatter for values pointing to an int.
+ * 
+ * @param buffer Destination of the text.
+ * @param value Pointer to an int.
+ * 
+ * @return The number of bytes written.
+ */
+size_t ll_format_int(char* buffer, const void* value);
+
+/*
+ * Returns the value of the element at the specified position in this list. 
+ * 
+ * @param list Pointer to the container.
+ * 
+ * @return The value of an element at a specified position in the list
+ */
+void* ll_get(struct LinkedList* list, size_t index);
+
+/*
+ * Initializes an empty list in a structure provided by the caller (on the stack or inside another
+ * structure). Nothing is allocated until the list outgrows its LL_SMALL_NODES inline nodes.
+ * ll_create is ll_init on a structure allocated by malloc.
+ * 
+ * @param list Pointer to the structure to initialize.
+ */
+void ll_init(struct LinkedList* list);
+
+/*
+ * The container is extended by inserting new elements before the element at the specified position.
+ *
+ * This effectively increases the list size by the amount of elements inserted.
+ * 
+ * @param list Pointer to the container.
+ * @param index Inserts the element at the specified position in this list.
+ * @param value Value of the inserted elements.
+ * @param n Number of elements to insert. Each element is initialized to a copy of value.
+ */
+void ll_insert(struct LinkedList* list, size_t index, void* value, size_t n);
+
+/*
+ * Inserts a new element right after node in O(1).
+ * 
+ * @param list Pointer to the container.
+ * @param node Element of the list after which the value is inserted, or NULL to insert at the beginning.
+ * @param value Value of the inserted element.
+ * 
+ * @return The new element.
+ */
+struct Node* ll_insert_after(struct LinkedList* list, struct Node* node, void* value);
+
+/*
+ * The container is extended by inserting n new elements before the element at the specified position.
+ * 
+ * The new nodes are linked in one pass, after a single walk to the position. Ranges of more than
+ * LL_SMALL_NODES elements get all their nodes from a single new block (the unused end of the block
+ * goes to the free nodes); smaller ranges take their nodes one by one like single insertions, from
+ * the free nodes, which include the small_nodes stored in the structure.
+ * 
+ * @param list Pointer to the container.
+ * @param index Position of the first inserted element (0 to ll_size(list); ll_size(list) appends).
+ * @param values Values of the inserted elements, in order.
+ * @param n Number of elements to insert.
+ */
+void ll_insert_range(struct LinkedList* list, size_t index, void** values, size_t n);
+
+/*
+ * Lazily removes an element in O(1): its value is destroyed at once but the node stays linked,
+ * and is skipped by the other functions. When the killed elements exceed the compaction threshold
+ * of the list, they are all unlinked by ll_compact.
+ * 
+ * @param list Pointer to the container.
+ * @param node A node of the list (as returned by ll_insert_after, for instance).
+ */
+void ll_kill(struct LinkedList* list, struct Node* node);
+
+/*
+ * Returns the value of the last element in this list. 
+ * 
+ * @param list Pointer to the container.
+ * 
+ * @return The value of the last element in the list
+ */
+void* ll_last(struct LinkedList* list);
+
+/*
+ * Merges two lists sorted according to compare in linear time, without allocating.
+ * 
+ * All the elements of other are moved to list, which stays sorted; other is left empty.
+ * When two values are equivalent, the one of list comes first.
+ * 
+ * @param list Pointer to the destination container (sorted).
+ * @param other Pointer to the source container (sorted).
+ * @param compare Order of the values.
+ */
+void ll_merge(struct LinkedList* list, struct LinkedList* other, ll_compare compare);
+
+/*
+ * Removes and returns the value of the last element in the list container, effectively reducing the container size by one.
+ * 
+ * The value is not destroyed: the caller becomes its owner and must free it.
+ * 
+ * @param list Pointer to the container.
+ * 
+ * @return The value of the last element of this list
+ */
+void* ll_pop_back(struct LinkedList* list);
+
+/*
+ * Removes and returns the value of the the first element in the list container, effectively reducing its size by one.
+ * 
+ * The value is not destroyed: the caller becomes its owner and must free it.
+ * 
+ * @param list Pointer to the container.
+ * 
+ * @return The value of the first element of this list
+ */
+void* ll_pop_front(struct LinkedList* list);
+
+/*
+ * Adds a new element at the end of the list container, after its current last element. The content of data is copied to the new element.
+ * 
+ * This effectively increases the container size by one.
+ * 
+ * @param list Pointer to the container.
+ * @param value Value to be copied to the new element.
+ */
+void ll_push_back(struct LinkedList* list, void* value);
+
+/*
+ * Inserts a new element at the beginning of the list, right before its current first element. The content of data is copied to the inserted element.
+ * 
+ * This effectively increases the container size by one.
+ * 
+ * @param list Pointer to the container.
+ * @param value Value to be copied to the new element.
+ */
+void ll_push_front(struct LinkedList* list, void* value);
+
+/*
+ * Reads a list written by ll_write from a file descriptor.
+ * 
+ * Input is read by large blocks and each value is copied to a newly allocated block of memory.
+ * The header and the record sizes are checked against the size of the stream when fd is a regular
+ * file, so a corrupted stream is refused before anything is allocated for it. A stream of fixed-size
+ * records of 0 bytes is refused, as nothing in it bounds the number of elements.
+ * 
+ * @param fd File descriptor to read from.
+ * 
+ * @return A new LinkedList, or NULL if the stream is truncated, is not a list, or holds a value that
+ * cannot be allocated.
+ */
+struct LinkedList* ll_read(int fd);
+
+/*
+ * Removes all elements from the list container without freeing their values, which now belong to the caller.
+ * 
+ * The nodes are released at once, like ll_clear.
+ * 
+ * @param list Pointer to the container.
+ */
+void ll_release(struct LinkedList* list);
+
+/*
+ * Removes the head (first element) of this list.
+ * 
+ * This destroys the removed element.
+ * 
+ * @param list Pointer to the container.
+ */
+void ll_remove(struct LinkedList* list);
+
+/*
+ * Removes the element at the specified position in this list.
+ * 
+ * This destroys the removed element.
+ * 
+ * @param list Pointer to the container
+ * @param index The index of the element to be removed
+ */
+void ll_remove_at(struct LinkedList* list, size_t index);
+
+/*
+ * Removes an element of the list in O(1).
+ * 
+ * This destroys the removed element.
+ * 
+ * @param list Pointer to the container
+ * @param node The element to be removed
+ */
+void ll_remove_node(struct LinkedList* list, struct Node* node);
+
+/*
+ * Removes all elements from the list container (which are destroyed), like ll_clear, but keeps
+ * the nodes: filling the list again up to the same size allocates no node.
+ * 
+ * @param list Pointer to the container.
+ */
+void ll_reset(struct LinkedList* list);
+
+/*
+ * Sets the fraction of killed elements at which the list is compacted. Below it, ll_get, ll_insert,
+ * ll_remove_at and the other indexed operations skip the killed elements instead of compacting.
+ * 
+ * @param list Pointer to the container.
+ * @param threshold From 0 (compact on every kill) to 1. LL_COMPACTION_THRESHOLD by default.
+ */
+void ll_set_compaction_threshold(struct LinkedList* list, double threshold);
+
+/*
+ * Sets the size of the values of the list: ll_contains compares value_size bytes, ll_clone and
+ * ll_insert (with n > 1) copy value_size bytes. LL_VALUE_SIZE by default.
+ * 
+ * @param list Pointer to the container.
+ * @param value_size Size of each value in bytes.
+ */
+void ll_set_value_size(struct LinkedList* list, size_t value_size);
+
+/*
+ * Returns the number of elements in the list container.
+ * Killed elements are not counted, even before the compaction.
+ * 
+ * @param list Pointer to the container
+ * 
+ * @return The size of the container
+ */
+size_t ll_size(struct LinkedList* list);
+
+/*
+ * Sorts the list in place according to compare.
+ * 
+ * This is a stable bottom-up merge sort: O(n log n), the elements are relinked and nothing is allocated.
+ * 
+ * @param list Pointer to the container.
+ * @param compare Order of the values.
+ */
+void ll_sort(struct LinkedList* list, ll_compare compare);
+
+/*
+ * Exchanges the value of x by the value of y, which is another value of the same type. Sizes may differ.
+ * 
+ * After the call to this function, the elements in x are those which were in y before the call, and the elements of y are those which were in x. 
+ * 
+ * @param list Pointer to the doubly linked list
+ * @param x Position of the first element
+ * @param y Position of the second element
+ */
+void ll_swap(struct LinkedList* list, size_t x, size_t y);
+
+/*
+ * Writes the list to a file descriptor using a compact binary format.
+ * 
+ * The stream starts with a header (magic "BSDL", version, record size, number of elements) followed by
+ * one record per element. Records are either value_size bytes copied from each value, or, when value_length
+ * is given, a 32-bit length followed by that many bytes. Integers use the byte order of the machine.
+ * Output is written by large blocks. Fixed-size records of 0 bytes cannot be read back by ll_read.
+ * 
+ * @param list Pointer to the container.
+ * @param fd File descriptor to write to.
+ * @param value_size Size of each value in bytes (ignored when value_length is not NULL).
+ * @param value_length Returns the size of a value in bytes, or NULL for fixed-size records.
+ * 
+ * @return 0 on success, -1 on write error.
+ */
+int ll_write(struct LinkedList* list, int fd, size_t value_size, size_t (*value_length)(const void* value));
+
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  /* LINKEDLIST_H */
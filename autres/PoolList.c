@@ -0,0 +1,229 @@
+/*
+ * This file is a part of the C LinkedList library.
+ *
+ * File:   PoolList.c
+ * Author: Loïc FORTIN <loic.fortin@etud.univ-montp2.fr>
+ */
+
+#include "PoolList.h"
+
+/*
+ * Returns a free slot, recycling a removed one when possible. The array doubles when it is full.
+ */
+static uint32_t pl_node_alloc(struct PoolList* list) {
+    if(list->free_slot != PL_NONE) {
+        uint32_t slot = list->free_slot;
+        list->free_slot = list->nodes[slot].next;
+        return slot;
+    }
+
+    if(list->used == list->capacity) {
+        // PL_NONE is not a valid slot
+        if(list->capacity >= PL_NONE / 2)
+            exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+
+        uint32_t capacity = list->capacity ? list->capacity * 2 : PL_MIN_CAPACITY;
+        struct pl_node* nodes = (struct pl_node*) realloc(list->nodes, capacity * sizeof(struct pl_node));
+
+        if(!nodes)
+            exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+
+        list->nodes = nodes;
+        list->capacity = capacity;
+    }
+
+    return list->used++;
+}
+
+struct PoolList* pl_clone(struct PoolList* list, void* (*copy)(const void* value)) {
+    struct PoolList* tmp = pl_create();
+
+    if(list->used == 0)
+        return tmp;
+
+    tmp->nodes = (struct pl_node*) malloc(list->used * sizeof(struct pl_node));
+
+    if(!tmp->nodes)
+        exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+
+    // Same slots, same links: only the values need a pass over the list
+    memcpy(tmp->nodes, list->nodes, list->used * sizeof(struct pl_node));
+    tmp->capacity = list->used;
+    tmp->used = list->used;
+    tmp->free_slot = list->free_slot;
+    tmp->first = list->first;
+    tmp->last = list->last;
+    tmp->length = list->length;
+
+    for(uint32_t ite = tmp->first; ite != PL_NONE; ite = tmp->nodes[ite].next)
+        tmp->nodes[ite].value = copy(list->nodes[ite].value);
+
+    return tmp;
+}
+
+void pl_compact(struct PoolList* list) {
+    if(list->length == 0) {
+        pl_fini(list);
+        return;
+    }
+
+    struct pl_node* nodes = (struct pl_node*) malloc(list->length * sizeof(struct pl_node));
+    uint32_t i = 0;
+
+    if(!nodes)
+        exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+
+    for(uint32_t ite = list->first; ite != PL_NONE; ite = list->nodes[ite].next, ++i) {
+        nodes[i].value = list->nodes[ite].value;
+        nodes[i].previous = i - 1; // PL_NONE for the first one
+        nodes[i].next = i + 1;
+    }
+
+    nodes[i - 1].next = PL_NONE;
+
+    free(list->nodes);
+    list->nodes = nodes;
+    list->capacity = i;
+    list->used = i;
+    list->free_slot = PL_NONE;
+    list->first = 0;
+    list->last = i - 1;
+}
+
+struct PoolList* pl_create() {
+    struct PoolList* list = (struct PoolList*) malloc(sizeof(struct PoolList));
+
+    if(!list)
+        exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+
+    pl_init(list);
+
+    return list;
+}
+
+void pl_destroy(struct PoolList* list) {
+    pl_fini(list);
+    free(list);
+}
+
+void pl_fini(struct PoolList* list) {
+    for(uint32_t ite = list->first; ite != PL_NONE; ite = list->nodes[ite].next)
+        free(list->nodes[ite].value);
+
+    free(list->nodes);
+    pl_init(list);
+}
+
+uint32_t pl_first(struct PoolList* list) {
+    return list->first;
+}
+
+void* pl_get(struct PoolList* list, size_t index) {
+    if(list->length == 0)
+        exit(EMPTY_LIST_EXCEPTION);
+
+    if(index >= list->length)
+        exit(INDEX_OUT_OF_RANGE_EXCEPTION);
+
+    uint32_t ite;
+
+    if(index < list->length / 2) {
+        ite = list->first;
+
+        for(size_t i = 0; i < index; ++i)
+            ite = list->nodes[ite].next;
+    }
+    else {
+        ite = list->last;
+
+        for(size_t i = list->length - 1; i > index; --i)
+            ite = list->nodes[ite].previous;
+    }
+
+    return list->nodes[ite].value;
+}
+
+void pl_init(struct PoolList* list) {
+    list->nodes = NULL;
+    list->capacity = 0;
+    list->used = 0;
+    list->free_slot = PL_NONE;
+    list->first = PL_NONE;
+    list->last = PL_NONE;
+    list->length = 0;
+}
+
+uint32_t pl_insert_after(struct PoolList* list, uint32_t slot, void* value) {
+    // Allocate first: the array may move
+    uint32_t tmp = pl_node_alloc(list);
+    struct pl_node* node = &list->nodes[tmp];
+
+    node->value = value;
+    node->previous = slot;
+    node->next = (slot != PL_NONE) ? list->nodes[slot].next : list->first;
+
+    if(slot != PL_NONE)
+        list->nodes[slot].next = tmp;
+    else
+        list->first = tmp;
+
+    if(node->next != PL_NONE)
+        list->nodes[node->next].previous = tmp;
+    else
+        list->last = tmp;
+
+    ++list->length;
+
+    return tmp;
+}
+
+uint32_t pl_last(struct PoolList* list) {
+    return list->last;
+}
+
+uint32_t pl_next(struct PoolList* list, uint32_t slot) {
+    return list->nodes[slot].next;
+}
+
+uint32_t pl_previous(struct PoolList* list, uint32_t slot) {
+    return list->nodes[slot].previous;
+}
+
+uint32_t pl_push_back(struct PoolList* list, void* value) {
+    return pl_insert_after(list, list->last, value);
+}
+
+uint32_t pl_push_front(struct PoolList* list, void* value) {
+    return pl_insert_after(list, PL_NONE, value);
+}
+
+void pl_remove(struct PoolList* list, uint32_t slot) {
+    struct pl_node* node = &list->nodes[slot];
+
+    free(node->value);
+
+    if(node->previous != PL_NONE)
+        list->nodes[node->previous].next = node->next;
+    else
+        list->first = node->next;
+
+    if(node->next != PL_NONE)
+        list->nodes[node->next].previous = node->previous;
+    else
+        list->last = node->previous;
+
+    node->value = NULL;
+    node->previous = PL_NONE;
+    node->next = list->free_slot;
+    list->free_slot = slot;
+
+    --list->length;
+}
+
+size_t pl_size(struct PoolList* list) {
+    return list->length;
+}
+
+void* pl_value(struct PoolList* list, uint32_t slot) {
+    return list->nodes[slot].value;
+}
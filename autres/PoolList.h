@@ -0,0 +1,195 @@
+/*
+ * This file is a part of the C LinkedList library.
+ *
+ * File:   PoolList.h
+ * Author: Loïc FORTIN <loic.fortin@etud.univ-montp2.fr>
+ *
+ * Doubly linked list whose nodes live in one growable array.
+ *
+ * The links are 32-bit indices into the array instead of pointers, so a node takes 16 bytes
+ * instead of 24 on 64-bit, and the nodes stay close together. A node is designated by its slot:
+ * slots do not move when the array grows, only pl_compact renumbers them.
+ *
+ * for(uint32_t ite = pl_first(list); ite != PL_NONE; ite = pl_next(list, ite))
+ *     use(pl_value(list, ite));
+ */
+
+#ifndef POOLLIST_H
+#define POOLLIST_H
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#include "LinkedList.h" // Exception codes
+
+#define PL_NONE UINT32_MAX // No node (end of the list, empty free list)
+#define PL_MIN_CAPACITY 8 // Number of slots allocated by the first insertion
+
+/*
+ * A node of the pool. A free slot is linked to the next free slot by next.
+ */
+struct pl_node {
+    void* value;
+    uint32_t previous;
+    uint32_t next;
+};
+
+/*
+ * This structure represent the array-backed doubly linked list.
+ */
+struct PoolList {
+    struct pl_node* nodes; // The pool
+    uint32_t capacity; // Allocated number of slots
+    uint32_t used; // Slots below used have been given out at least once
+    uint32_t free_slot; // First recycled slot, PL_NONE if there is none
+    uint32_t first; // Slot of the first element, PL_NONE if the list is empty
+    uint32_t last; // Slot of the last element, PL_NONE if the list is empty
+    size_t length; // Length of the list
+};
+
+/*
+ * Returns a copy of the list. The nodes are copied with a single memcpy, in the same slots.
+ *
+ * @param list Pointer to the container.
+ * @param copy Returns a copy of a value (the copy owns its values, like the list).
+ *
+ * @return A copy of the list
+ */
+struct PoolList* pl_clone(struct PoolList* list, void* (*copy)(const void* value));
+
+/*
+ * Moves the nodes so that slot i holds the i-th element, and releases the unused slots.
+ * A scan of the list then reads the array from the beginning to the end.
+ * The slots held by the caller are no longer valid.
+ *
+ * @param list Pointer to the container.
+ */
+void pl_compact(struct PoolList* list);
+
+/*
+ * Create a new list container.
+ *
+ * @return A new PoolList
+ */
+struct PoolList* pl_create();
+
+/*
+ * Destroy a list container and its values.
+ *
+ * @param list Pointer to the container.
+ */
+void pl_destroy(struct PoolList* list);
+
+/*
+ * Destroys the values and the pool of a list initialized by pl_init, but not the structure itself.
+ *
+ * @param list Pointer to the container.
+ */
+void pl_fini(struct PoolList* list);
+
+/*
+ * Returns the slot of the first element, PL_NONE if the list is empty.
+ *
+ * @param list Pointer to the container.
+ */
+uint32_t pl_first(struct PoolList* list);
+
+/*
+ * Returns the value of the element at position index, walking from the nearest end.
+ *
+ * @param list Pointer to the container.
+ * @param index Position of an element in the list.
+ */
+void* pl_get(struct PoolList* list, size_t index);
+
+/*
+ * Initializes an empty list in a structure provided by the caller. Nothing is allocated.
+ *
+ * @param list Pointer to the structure to initialize.
+ */
+void pl_init(struct PoolList* list);
+
+/*
+ * Inserts a value after the element in slot, or at the beginning if slot is PL_NONE.
+ *
+ * @param list Pointer to the container.
+ * @param slot Slot of an element of the list, or PL_NONE.
+ * @param value Value of the inserted element.
+ *
+ * @return The slot of the new element.
+ */
+uint32_t pl_insert_after(struct PoolList* list, uint32_t slot, void* value);
+
+/*
+ * Returns the slot of the last element, PL_NONE if the list is empty.
+ *
+ * @param list Pointer to the container.
+ */
+uint32_t pl_last(struct PoolList* list);
+
+/*
+ * Returns the slot of the element after the element in slot, PL_NONE at the end.
+ *
+ * @param list Pointer to the container.
+ * @param slot Slot of an element of the list.
+ */
+uint32_t pl_next(struct PoolList* list, uint32_t slot);
+
+/*
+ * Returns the slot of the element before the element in slot, PL_NONE at the beginning.
+ *
+ * @param list Pointer to the container.
+ * @param slot Slot of an element of the list.
+ */
+uint32_t pl_previous(struct PoolList* list, uint32_t slot);
+
+/*
+ * Adds a new element at the end of the list.
+ *
+ * @param list Pointer to the container.
+ * @param value Value of the inserted element.
+ *
+ * @return The slot of the new element.
+ */
+uint32_t pl_push_back(struct PoolList* list, void* value);
+
+/*
+ * Adds a new element at the beginning of the list.
+ *
+ * @param list Pointer to the container.
+ * @param value Value of the inserted element.
+ *
+ * @return The slot of the new element.
+ */
+uint32_t pl_push_front(struct PoolList* list, void* value);
+
+/*
+ * Removes the element in slot, which is destroyed. The slot is recycled by the next insertion.
+ *
+ * @param list Pointer to the container.
+ * @param slot Slot of an element of the list.
+ */
+void pl_remove(struct PoolList* list, uint32_t slot);
+
+/*
+ * Returns the number of elements in the list container.
+ *
+ * @param list Pointer to the container.
+ */
+size_t pl_size(struct PoolList* list);
+
+/*
+ * Returns the value of the element in slot.
+ *
+ * @param list Pointer to the container.
+ * @param slot Slot of an element of the list.
+ */
+void* pl_value(struct PoolList* list, uint32_t slot);
+
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  /* POOLLIST_H */
@@ -0,0 +1,204 @@
+/*
+ * This file is a part of the C LinkedList library.
+ *
+ * File:   SortedList.c
+ * Author: Loïc FORTIN <loic.fortin@etud.univ-montp2.fr>
+ */
+
+#include "SortedList.h"
+
+/*
+ * Returns the number of segments whose first value is before value
+ * (or before or equivalent to value when inclusive is true).
+ */
+static size_t sl_bound(struct SortedList* sorted, const void* value, bool inclusive) {
+    size_t low = 0;
+    size_t high = sorted->skip_count;
+
+    while(low < high) {
+        size_t middle = low + (high - low) / 2;
+        int c = sorted->compare(sorted->skips[middle].node->value, value);
+
+        if(c < 0 || (inclusive && c == 0))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+/*
+ * Inserts a segment at position k.
+ */
+static void sl_add_skip(struct SortedList* sorted, size_t k, struct Node* node, size_t count) {
+    if(sorted->skip_count == sorted->skip_capacity) {
+        size_t capacity = sorted->skip_capacity ? sorted->skip_capacity * 2 : 4;
+        struct sl_skip* skips = (struct sl_skip*) realloc(sorted->skips, capacity * sizeof(struct sl_skip));
+
+        if(!skips)
+            exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+
+        sorted->skips = skips;
+        sorted->skip_capacity = capacity;
+    }
+
+    memmove(sorted->skips + k + 1, sorted->skips + k, (sorted->skip_count - k) * sizeof(struct sl_skip));
+    sorted->skips[k].node = node;
+    sorted->skips[k].count = count;
+    ++sorted->skip_count;
+}
+
+/*
+ * Rebuilds all the segments in one pass over the list.
+ */
+static void sl_rebuild(struct SortedList* sorted) {
+    size_t i = 0;
+
+    sorted->skip_count = 0;
+
+    for(struct Node* ite = sorted->list->first; ite; ite = ite->next, ++i) {
+        if(i % SL_STRIDE == 0)
+            sl_add_skip(sorted, sorted->skip_count, ite, 0);
+
+        ++sorted->skips[sorted->skip_count - 1].count;
+    }
+}
+
+/*
+ * Searches the first node equivalent to value.
+ * Returns NULL if there is none; otherwise *segment and *position receive its place.
+ */
+static struct Node* sl_find(struct SortedList* sorted, const void* value, size_t* segment, size_t* position) {
+    size_t k = sl_bound(sorted, value, false);
+
+    if(sorted->skip_count == 0)
+        return NULL;
+
+    // Equivalent values may start at the end of the previous segment
+    if(k > 0)
+        --k;
+
+    struct Node* ite = sorted->skips[k].node;
+    size_t i = 0;
+
+    while(ite && sorted->compare(ite->value, value) < 0) {
+        ite = ite->next;
+
+        if(++i == sorted->skips[k].count) {
+            ++k;
+            i = 0;
+        }
+    }
+
+    if(!ite || sorted->compare(ite->value, value) != 0)
+        return NULL;
+
+    *segment = k;
+    *position = i;
+
+    return ite;
+}
+
+bool sl_contains(struct SortedList* sorted, const void* value) {
+    size_t segment;
+    size_t position;
+
+    return sl_find(sorted, value, &segment, &position) != NULL;
+}
+
+struct SortedList* sl_create(ll_compare compare) {
+    struct SortedList* sorted = (struct SortedList*) malloc(sizeof(struct SortedList));
+
+    if(!sorted)
+        exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
+
+    sorted->list = ll_create();
+    sorted->compare = compare;
+    sorted->skips = NULL;
+    sorted->skip_count = 0;
+    sorted->skip_capacity = 0;
+
+    return sorted;
+}
+
+void sl_destroy(struct SortedList* sorted) {
+    ll_destroy(sorted->list);
+    free(sorted->skips);
+    free(sorted);
+}
+
+void sl_insert(struct SortedList* sorted, void* value) {
+    // Last segment whose first value is before or equivalent to value
+    size_t k = sl_bound(sorted, value, true);
+
+    if(k == 0) {
+        // The value becomes the first element
+        struct Node* node = ll_insert_after(sorted->list, NULL, value);
+
+        if(sorted->skip_count == 0)
+            sl_add_skip(sorted, 0, node, 0);
+
+        sorted->skips[0].node = node;
+    }
+    else {
+        --k;
+
+        struct Node* ite = sorted->skips[k].node;
+
+        // Walk inside the segment, after the equivalent values
+        for(size_t i = 1; i < sorted->skips[k].count && sorted->compare(ite->next->value, value) <= 0; ++i)
+            ite = ite->next;
+
+        ll_insert_after(sorted->list, ite, value);
+    }
+
+    ++sorted->skips[k].count;
+
+    // Split the segment when it becomes too long
+    if(sorted->skips[k].count > 2 * SL_STRIDE) {
+        struct Node* middle = sorted->skips[k].node;
+
+        for(size_t i = 0; i < SL_STRIDE; ++i)
+            middle = middle->next;
+
+        sl_add_skip(sorted, k + 1, middle, sorted->skips[k].count - SL_STRIDE);
+        sorted->skips[k].count = SL_STRIDE;
+    }
+}
+
+void sl_merge(struct SortedList* sorted, struct SortedList* other) {
+    if(other == sorted)
+        return;
+
+    ll_merge(sorted->list, other->list, sorted->compare);
+    other->skip_count = 0;
+    sl_rebuild(sorted);
+}
+
+bool sl_remove(struct SortedList* sorted, const void* value) {
+    size_t k;
+    size_t position;
+    struct Node* node = sl_find(sorted, value, &k, &position);
+
+    if(!node)
+        return false;
+
+    struct Node* next = node->next;
+
+    ll_remove_node(sorted->list, node);
+
+    if(--sorted->skips[k].count == 0) {
+        memmove(sorted->skips + k, sorted->skips + k + 1, (sorted->skip_count - k - 1) * sizeof(struct sl_skip));
+        --sorted->skip_count;
+    }
+    else if(position == 0) {
+        sorted->skips[k].node = next;
+    }
+
+    return true;
+}
+
+size_t sl_size(struct SortedList* sorted) {
+    return ll_size(sorted->list);
+}
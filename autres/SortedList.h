@@ -0,0 +1,110 @@
+/*
+ * This file is a part of the C LinkedList library.
+ *
+ * File:   SortedList.h
+ * Author: Loïc FORTIN <loic.fortin@etud.univ-montp2.fr>
+ *
+ * A LinkedList kept sorted by its comparison function.
+ *
+ * Besides the list, the container keeps skip pointers: the first node of every segment of
+ * about SL_STRIDE consecutive nodes. A search is a binary search over the segments followed
+ * by a walk of at most 2 * SL_STRIDE nodes, instead of a walk of the whole list.
+ */
+
+#ifndef SORTEDLIST_H
+#define SORTEDLIST_H
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#include "LinkedList.h"
+
+#define SL_STRIDE 32 // Target number of nodes per segment
+
+/*
+ * A segment of the list: its first node and its number of nodes.
+ */
+struct sl_skip {
+    struct Node* node;
+    size_t count;
+};
+
+/*
+ * This structure represent a sorted list.
+ * The list may be read with the ll_* functions, but it must only be modified through the sl_* functions.
+ */
+struct SortedList {
+    struct LinkedList* list; // The sorted elements
+    ll_compare compare; // Order of the values
+    struct sl_skip* skips; // Segments of the list, in order
+    size_t skip_count; // Number of segments
+    size_t skip_capacity; // Allocated number of segments
+};
+
+/*
+ * Returns true if this list contains a value equivalent to value.
+ *
+ * @param sorted Pointer to the container.
+ * @param value The value to search for.
+ */
+bool sl_contains(struct SortedList* sorted, const void* value);
+
+/*
+ * Create a new sorted list container.
+ *
+ * @param compare Order of the values.
+ *
+ * @return A new SortedList
+ */
+struct SortedList* sl_create(ll_compare compare);
+
+/*
+ * Destroy a sorted list container and its values.
+ *
+ * @param sorted Pointer to the container.
+ */
+void sl_destroy(struct SortedList* sorted);
+
+/*
+ * Inserts a value at its place in O(log n + SL_STRIDE). Equivalent values keep their insertion order.
+ *
+ * @param sorted Pointer to the container.
+ * @param value Value of the inserted element.
+ */
+void sl_insert(struct SortedList* sorted, void* value);
+
+/*
+ * Moves all the elements of other to sorted in linear time, leaving other empty.
+ * Both lists must use the same order.
+ *
+ * @param sorted Pointer to the destination container.
+ * @param other Pointer to the source container.
+ */
+void sl_merge(struct SortedList* sorted, struct SortedList* other);
+
+/*
+ * Removes the first element equivalent to value.
+ *
+ * This destroys the removed element.
+ *
+ * @param sorted Pointer to the container.
+ * @param value The value to search for.
+ *
+ * @return true if an element was removed, false otherwise.
+ */
+bool sl_remove(struct SortedList* sorted, const void* value);
+
+/*
+ * Returns the number of elements in the sorted list.
+ *
+ * @param sorted Pointer to the container
+ */
+size_t sl_size(struct SortedList* sorted);
+
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  /* SORTEDLIST_H */
@@ -1,574 +1,117 @@
+#define _POSIX_C_SOURCE 200809L // fileno
 
 /* 
  * This file is a part of the C LinkedList library.
  * 
- * File:   LinkedList.h
+ * File:   loicCode.c
  * Author: Loïc FORTIN <loic.fortin@etud.univ-montp2.fr>
  *
- * Created on 3 octobre 2014, 09:08
+ * Created on 7 octobre 2014, 10:48
  */
 
-#ifndef LINKEDLIST_H
-#define LINKEDLIST_H
-
-#ifdef  __cplusplus
-extern "C" {
-#endif
-
+#include <stdio.h>
 #include <stdlib.h>
-#include <stdbool.h> // bool
-#include <string.h> // memcpy, memcmp
-
-#define EMPTY_LIST_EXCEPTION 10
-#define INDEX_OUT_OF_RANGE_EXCEPTION 11
-#define NUMBER_INSERTION_EXCEPTION 12
-#define MEMORY_ALLOCATION_FAIL_EXCEPTION 13
-#define CIRCULAR_REFERENCE_EXCEPTION 14
+#include <unistd.h> // lseek
+#include <pthread.h>
+#include "LinkedList.h"
+#include "GenericList.h"
+#include "ImmutableList.h"
+#include "IntrusiveList.h"
+#include "PoolList.h"
+#include "SortedList.h"
+#include "../Recyclage.h"
 
 /*
- * This structure represent a single element (node) on the list.
- * It stores the data and has a pointer to the previous and next element (node) of the list.
+ * Order of the values pointing to an int.
  */
-struct Node {
-    void* value;
-    struct Node* previous;
-    struct Node* next;
-};
-
-/*
- * This structure represent the doubly linked list.
- * It stores the length of the list and has a pointer to the first and last element.
- */
-struct LinkedList {
-    size_t length; // Length of the list
-    struct Node* first; // Pointer to the last element of the list
-    struct Node* last; // Pointer to the last element of the list
-};
-
-/*
- * Removes all elements from the list container (which are destroyed), and leaving the container with a size of 0.
- * 
- * @param list Pointer to the container.
- */
-void ll_clear(struct LinkedList* list);
-
-/*
- * Returns a copy of the LinkedList.
- * 
- * @param list Pointer to the container.
- * 
- * @return A copy of the list
- */
-struct LinkedList* ll_clone(struct LinkedList* list);
-
-/*
- * Returns true if this list contains the specified element, false otherwise.
- * 
- * @param list Pointer to the container
- * @param value The value to search for.
- */
-bool ll_contains(struct LinkedList* list, void* value);
-
-/*
- * Create a new list container.
- * 
- * @param list Pointer to the container.
- * 
- * @return A new LinkedList
- */
-struct LinkedList* ll_create();
-
-/*
- * Destroy a list container
- * 
- * @param list Pointer to the container.
- */
-void ll_destroy(struct LinkedList* list);
-
-/*
- * Returns whether the list container is empty (i.e. whether its size is 0).
- * 
- * @param list Pointer to the container.
- * 
- * @return true if the container size is 0, false otherwise.
- */
-bool ll_empty(struct LinkedList* list);
-
-/*
- * Returns the value of the first element in this list. 
- * 
- * @param list Pointer to the container.
- * 
- * @return The value of the first element in the list
- */
-void* ll_first(struct LinkedList* list);
-
-/*
- * Returns the value of the element at the specified position in this list. 
- * 
- * @param list Pointer to the container.
- * 
- * @return The value of an element at a specified position in the list
- */
-void* ll_get(struct LinkedList* list, size_t index);
-
-/*
- * The container is extended by inserting new elements before the element at the specified position.
- *
- * This effectively increases the list size by the amount of elements inserted.
- * 
- * @param list Pointer to the container.
- * @param index Inserts the element at the specified position in this list.
- * @param value Value of the inserted elements.
- * @param n Number of elements to insert. Each element is initialized to a copy of value.
- */
-void ll_insert(struct LinkedList* list, size_t index, void* value, size_t n);
-
-/*
- * Returns the value of the last element in this list. 
- * 
- * @param list Pointer to the container.
- * 
- * @return The value of the last element in the list
- */
-void* ll_last(struct LinkedList* list);
-
-/*
- * Removes and returns the value of the last element in the list container, effectively reducing the container size by one.
- * 
- * This destroys the removed element.
- * 
- * @param list Pointer to the container.
- * 
- * @return The value of the last element of this list
- */
-void* ll_pop_back(struct LinkedList* list);
-
-/*
- * Removes and returns the value of the the first element in the list container, effectively reducing its size by one.
- * 
- * This destroys the removed element.
- * 
- * @param list Pointer to the container.
- * 
- * @return The value of the first element of this list
- */
-void* ll_pop_front(struct LinkedList* list);
-
-/*
- * Adds a new element at the end of the list container, after its current last element. The content of data is copied to the new element.
- * 
- * This effectively increases the container size by one.
- * 
- * @param list Pointer to the container.
- * @param value Value to be copied to the new element.
- */
-void ll_push_back(struct LinkedList* list, void* value);
-
-/*
- * Inserts a new element at the beginning of the list, right before its current first element. The content of data is copied to the inserted element.
- * 
- * This effectively increases the container size by one.
- * 
- * @param list Pointer to the container.
- * @param value Value to be copied to the new element.
- */
-void ll_push_front(struct LinkedList* list, void* value);
-
-/*
- * Removes the head (first element) of this list.
- * 
- * This destroys the removed element.
- * 
- * @param list Pointer to the container.
- */
-void ll_remove(struct LinkedList* list);
-
-/*
- * Removes the element at the specified position in this list.
- * 
- * This destroys the removed element.
- * 
- * @param list Pointer to the container
- * @param index The index of the element to be removed
- */
-void ll_remove_at(struct LinkedList* list, size_t index);
+static int compare_int(const void* a, const void* b) {
+    int x = *((const int*) a);
+    int y = *((const int*) b);
+    
+    return (x > y) - (x < y);
+}
 
 /*
- * Returns the number of elements in the list container.
- * 
- * @param list Pointer to the container
- * 
- * @return The size of the container
+ * List of ints stored in the nodes.
  */
-size_t ll_size(struct LinkedList* list);
+DEFINE_LIST(IntList, int)
 
 /*
- * Exchanges the value of x by the value of y, which is another value of the same type. Sizes may differ.
- * 
- * After the call to this function, the elements in x are those which were in y before the call, and the elements of y are those which were in x. 
- * 
- * @param list Pointer to the doubly linked list
- * @param x Position of the first element
- * @param y Position of the second element
+ * Returns a newly allocated int.
  */
-void ll_swap(struct LinkedList* list, size_t x, size_t y);
-
-
-#ifdef  __cplusplus
+static int* new_int(int x) {
+    int* val = (int*) malloc(sizeof(int));
+    *val = x;
+    return val;
 }
-#endif
-
-#endif  /* LINKEDLIST_H */
-
-
-
-
 
-///////////////////////////////////////////////////////////////////////////
-
-
-
-/* 
- * This file is a part of the C LinkedList library.
- * 
- * File:   LinkedList.h
- * Author: Loïc FORTIN <loic.fortin@etud.univ-montp2.fr>
- *
- * Created on 6 octobre 2014, 07:41
+/*
+ * Formatter writing 15 bytes for 0 and LL_FORMAT_MAX bytes for any other int.
  */
-
-//#include "LinkedList.h"
-
-void ll_clear(struct LinkedList* list) {
-    // Iterate until the list is empty
-    while(!ll_empty(list)) {
-        ll_remove(list);
-    }
-}
-
-struct LinkedList* ll_clone(struct LinkedList* list) {
-    struct LinkedList* tmp = ll_create();
-    struct Node* ite = list->first;
-    
-    // Iterate until the end of the list
-    while(ite) {
-        /*
-         * We must allocate a new block of memory to copy the value.
-         * ite->value is a void*. We are allocating 1*sizeof(ite->value) so we don't need a
-         * void** but a simple void* (in this case, using void** is not necessary because 
-         * malloc return a pointer to a single block of memory, which is equivalent to a table 
-         * with only one line).
-         */
-        void* value = (void*) malloc(sizeof(ite->value));
-        
-        if(!value)
-            exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
-        
-        memcpy(value, ite->value, sizeof(ite->value));
-        ll_push_back(tmp, value);
-        ite = ite->next;
-        
-        if(ite == list->first) {
-            exit(CIRCULAR_REFERENCE_EXCEPTION);
-        }
-    }
-    
-    return tmp;
-}
-
-bool ll_contains(struct LinkedList* list, void* value) {
-    if(ll_empty(list))
-        return false;
-    
-    struct Node* ite = list->first;
-    
-    // Iterate until we reach the value
-    while(ite && (memcmp(ite->value, value, sizeof(value)) != 0)) {
-        ite = ite->next;
-        
-        if(ite == list->first) {
-            exit(CIRCULAR_REFERENCE_EXCEPTION);
-        }
-    }
-    
-    return ((ite && (memcmp(ite->value, value, sizeof(value)) == 0)) ? true : false);
-}
-
-struct LinkedList* ll_create() {
-    struct LinkedList* list = (struct LinkedList*) malloc(sizeof(struct LinkedList));
-    
-    if(!list)
-        exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
-    
-    list->first = NULL;
-    list->last = NULL;
-    list->length = 0;
-    
-    return list;
-}
-
-void ll_destroy(struct LinkedList* list) {
-    ll_clear(list);
-    free(list);
-}
-
-bool ll_empty(struct LinkedList* list) {
-    return ((list->length == 0) ? true : false);
-}
-
-void* ll_first(struct LinkedList* list) {
-    if(ll_empty(list))
-        exit(EMPTY_LIST_EXCEPTION);
-    
-    return list->first->value;
-}
-
-void* ll_get(struct LinkedList* list, size_t index) {
-    if(ll_empty(list))
-        exit(EMPTY_LIST_EXCEPTION);
-    
-    //if(index < 0 || index >= list->length)
-    if(index >= list->length)
-        exit(INDEX_OUT_OF_RANGE_EXCEPTION);
-    
-    struct Node* ite = list->first;
-    size_t i = 0;
-    
-    // Iterate until we reach the position
-    while(i != index) {
-        ite = ite->next;
-        ++i;
-    }
-    
-    return ite->value;
-}
-
-void ll_insert(struct LinkedList* list, size_t index, void* value, size_t n) {
-    if(n < 1)
-        exit(NUMBER_INSERTION_EXCEPTION);
-    
-    size_t k = 0; // Number of elements insered
-    
-    // If list is empty AND index == 0, we create a new element
-    if(ll_empty(list) && index == 0) {
-        struct Node* tmp = (struct Node*) malloc(sizeof(struct Node));
-
-        if(!tmp)
-            exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
-
-        // Updating element
-        tmp->previous = NULL;
-        tmp->next = NULL;
-        tmp->value = value;
-
-        // Updating list
-        list->first = tmp;
-        list->last = tmp;
-        ++list->length;
-        
-        ++k;
-    }
-
-    //if(index < 0 || index >= list->length)
-    if(index >= list->length)
-        exit(INDEX_OUT_OF_RANGE_EXCEPTION);
-    
-    struct Node* ite = list->first;
-    size_t j = 0;
-    
-    // Iterate until we reach the position
-    while(j != index) {
-        ite = ite->next;
-        ++j;
-    }
-    
-    while(k < n) {
-        struct Node* tmp = (struct Node*) malloc(sizeof(struct Node));
-
-        if(!tmp)
-            exit(MEMORY_ALLOCATION_FAIL_EXCEPTION);
-        
-        // Updating element
-        tmp->previous = ite->previous;
-        tmp->next = ite;
-        tmp->value = value;
-        ite->previous = tmp;
-        
-        // If it is the first element, we need to update the list
-        if(tmp->previous == NULL)
-            list->first = tmp;
-        else
-            (tmp->previous)->next = tmp;
-        
-        ++list->length;
-        
-        ++k;
-    }
-}
-
-void* ll_last(struct LinkedList* list) {
-    if(ll_empty(list))
-        exit(EMPTY_LIST_EXCEPTION);
-    
-    return list->last->value;
-}
-
-void* ll_pop_back(struct LinkedList* list) {
-    void* value = ll_last(list);
-    
-    ll_remove_at(list, list->length - 1);
-    
-    return value;
-}
-
-void* ll_pop_front(struct LinkedList* list) {
-    void* value = ll_first(list);
-    
-    ll_remove(list);
+static size_t format_wide(char* buffer, const void* value) {
+    size_t n = *((const int*) value) == 0 ? 15 : LL_FORMAT_MAX;
     
-    return value;
-}
-
-void ll_push_back(struct LinkedList* list, void* value) {
-    if(ll_empty(list)) {
-        ll_push_front(list, value);
-    }
-    else {
-        ll_insert(list, list->length - 1, value, 1);
-        ll_swap(list, list->length - 2, list->length - 1);
-    }
-}
-
-void ll_push_front(struct LinkedList* list, void* value) {
+    for(size_t i = 0; i < n; ++i)
+        buffer[i] = 'x';
     
-    ll_insert(list, 0, value, 1);
+    return n;
 }
 
-void ll_remove(struct LinkedList* list) {
-    ll_remove_at(list, 0);
+/*
+ * Length of the int values, for length-prefixed records.
+ */
+static size_t int_length(const void* value) {
+    (void) value;
+    return sizeof(int);
 }
 
-void ll_remove_at(struct LinkedList* list, size_t index) {
-    if(ll_empty(list))
-        exit(EMPTY_LIST_EXCEPTION);
-    
-    //if(index < 0 || index >= list->length)
-    if(index >= list->length)
-        exit(INDEX_OUT_OF_RANGE_EXCEPTION);
-    
-    struct Node* tmp = list->first;
-    size_t i = 0;
-    
-    // Iterate until we reach the position
-    while(i != index) {
-        tmp = tmp->next;
-        ++i;
-    }
-    
-    free(tmp->value);
-    
-    if(tmp->previous != NULL) {
-        (tmp->previous)->next = tmp->next;
-    }
-    else {
-        list->first = tmp->next;
-    }
+/*
+ * Writes list to a temporary file, patches the 64-bit word at offset with patch and reads it back.
+ * Returns true if ll_read refused the stream.
+ */
+static bool read_refused(struct LinkedList* list, size_t value_size, size_t (*value_length)(const void* value), off_t offset, uint64_t patch) {
+    FILE* file = tmpfile();
     
-    if(tmp->next != NULL) {
-        (tmp->next)->previous = tmp->previous;
-    }
-    else {
-        list->last = tmp->previous;
-    }
+    ll_write(list, fileno(file), value_size, value_length);
+    pwrite(fileno(file), &patch, sizeof(patch), offset);
+    lseek(fileno(file), 0, SEEK_SET);
     
-    tmp->previous = NULL;
-    tmp->next = NULL;
+    struct LinkedList* read = ll_read(fileno(file));
+    fclose(file);
     
-    free(tmp);
+    if(read)
+        ll_destroy(read);
     
-    --list->length;
+    return read == NULL;
 }
 
-size_t ll_size(struct LinkedList* list) {
-    return list->length;
-}
+/*
+ * Reader thread of the immutable list test: sums its snapshot without any lock, then releases it.
+ */
+struct Reader {
+    struct ImmutableList* snapshot;
+    long sum;
+};
 
-void ll_swap(struct LinkedList* list, size_t x, size_t y) {
-    if(ll_empty(list))
-        exit(EMPTY_LIST_EXCEPTION);
-    
-    //if(x < 0 || x >= list->length)
-    if(x >= list->length)
-        exit(INDEX_OUT_OF_RANGE_EXCEPTION);
-    
-    //if(y < 0 || y >= list->length)
-    if(y >= list->length)
-        exit(INDEX_OUT_OF_RANGE_EXCEPTION);
-    
-    struct Node* xtmp = list->first;
-    size_t i = 0;
-    
-    // Iterate until we reach the position
-    while(i != x) {
-        xtmp = xtmp->next;
-        ++i;
-    }
+static void* read_snapshot(void* arg) {
+    struct Reader* reader = (struct Reader*) arg;
     
-    struct Node* ytmp = list->first;
-    size_t j = 0;
+    reader->sum = 0;
     
-    // Iterate until we reach the position
-    while(j != y) {
-        ytmp = ytmp->next;
-        ++j;
-    }
+    for(struct ImmutableList* ite = reader->snapshot; ite; ite = ite->next)
+        reader->sum += *((int*) ite->value);
     
-    void* vtmp = xtmp->value;
-    xtmp->value = ytmp->value;
-    ytmp->value = vtmp;
+    il_release(reader->snapshot);
+    return NULL;
 }
 
-
-
-
-
-
-
-
-////////////////////////////////////////////////////////////
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-///////////////////////////////////////////////////////////////////////
-
-
-
-
-
-/* 
- * This file is a part of the C LinkedList library.
- * 
- * File:   LinkedList.h
- * Author: Loïc FORTIN <loic.fortin@etud.univ-montp2.fr>
- *
- * Created on 7 octobre 2014, 10:48
+/*
+ * Element of the intrusive list test: the links live inside the object.
  */
-
-#include <stdio.h>
-#include <stdlib.h>
-//#include "LinkedList.h"
+struct Item {
+    int value;
+    struct ll_link link;
+};
 
 /*
  * 
@@ -578,6 +121,9 @@ int main(int argc, char** argv) {
     
     struct LinkedList* list = ll_create();
     
+    // ll_contains and ll_clone work on the bytes of the values
+    ll_set_value_size(list, sizeof(int));
+    
     if(ll_empty(list))
         printf("Empty list\n");
     else
@@ -619,6 +165,30 @@ int main(int argc, char** argv) {
     
     printf("Listing values :\n");
     
+    fflush(stdout);
+    ll_dump(list, STDOUT_FILENO, ll_format_int);
+    
+    char text[16];
+    size_t needed = ll_dump_buffer(list, text, sizeof(text), ll_format_int);
+    printf("Text needs %zu bytes, truncated : \"%s\"\n", needed, text);
+    
+    // 16 + 1008 * (LL_FORMAT_MAX + 1) = 65536 : the last value fills the buffer up to its end
+    struct LinkedList* wide = ll_create();
+    
+    for(int i = 0; i < 1009; ++i)
+        ll_push_back(wide, new_int(i));
+    
+    FILE* wide_file = tmpfile();
+    ll_dump(wide, fileno(wide_file), format_wide);
+    
+    off_t end = lseek(fileno(wide_file), 0, SEEK_END);
+    char last = 0;
+    pread(fileno(wide_file), &last, 1, end - 1);
+    printf("Full buffer : %lld bytes, %s\n", (long long) end, last == '\n' ? "newline ok" : "NEWLINE MISSING");
+    fclose(wide_file);
+    
+    ll_destroy(wide);
+    
     for(size_t i = 1; i <= ll_size(list); ++i)
         printf("Number %zu = %d\n", i, *((int*) ll_get(list, i-1)));
     
@@ -636,6 +206,8 @@ int main(int argc, char** argv) {
         printf("not found\n");
     }
     
+    free(dval);
+    
     printf("Search for value 894... ");
     int* dval2 = (int*) malloc(sizeof(int));
     *dval2 = 894;
@@ -650,6 +222,8 @@ int main(int argc, char** argv) {
         printf("not found\n");
     }
     
+    free(dval2);
+    
     printf("Getting value 10 : %d\n", *((int*) ll_get(list, 9)));
     
     printf("Cloning list (name : list2)\n");
@@ -661,6 +235,34 @@ int main(int argc, char** argv) {
     for(size_t i = 1; i <= ll_size(list2); ++i)
         printf("list2 : Number %zu = %d\n", i, *((int*) ll_get(list2, i-1)));
     
+    printf("Writing list2 to a file and reading it back (name : list3)\n");
+    
+    FILE* file = tmpfile();
+    
+    if(ll_write(list2, fileno(file), sizeof(int), NULL) != 0)
+        printf("write failed\n");
+    
+    lseek(fileno(file), 0, SEEK_SET);
+    struct LinkedList* list3 = ll_read(fileno(file));
+    fclose(file);
+    
+    bool same = list3 && ll_size(list3) == ll_size(list2);
+    
+    for(size_t i = 0; same && i < ll_size(list2); ++i)
+        same = *((int*) ll_get(list2, i)) == *((int*) ll_get(list3, i));
+    
+    printf("list3 %s list2\n", same ? "equals" : "DIFFERS FROM");
+    
+    if(list3)
+        ll_destroy(list3);
+    
+    // Header at offset 0 (its length at offset 16), first record at offset 24
+    bool refused = read_refused(list2, sizeof(int), NULL, 16, UINT64_MAX / 2)
+        && read_refused(list2, 0, NULL, 16, UINT64_MAX / 2)
+        && read_refused(list2, 0, int_length, 24, UINT32_MAX);
+    
+    printf("Corrupted streams %s\n", refused ? "refused" : "ACCEPTED");
+    
     printf("Removing first value (list)...\n");
     
     ll_remove(list);
@@ -684,10 +286,290 @@ int main(int argc, char** argv) {
     printf("Destroying list2\n");
     
     ll_destroy(list2);
+    
+    printf("Intrusive list : adding 5 items, removing the even ones\n");
+    
+    struct Item items[5];
+    struct ll_link head;
+    struct ll_link* ite;
+    struct ll_link* tmp;
+    
+    ll_link_init(&head);
+    
+    for(int i = 0; i < 5; ++i) {
+        items[i].value = i + 1;
+        ll_link_add_tail(&head, &items[i].link);
+    }
+    
+    ll_link_for_each_safe(ite, tmp, &head) {
+        if(ll_container_of(ite, struct Item, link)->value % 2 == 0)
+            ll_link_del(ite);
+    }
+    
+    ll_link_for_each(ite, &head)
+        printf("%d ", ll_container_of(ite, struct Item, link)->value);
+    printf("\n");
+
+    printf("Sorting a list of 200 values... ");
+    
+    struct LinkedList* list4 = ll_create();
+    
+    for(int i = 0; i < 200; ++i)
+        ll_push_front(list4, new_int((i * 7919) % 211));
+    
+    ll_sort(list4, compare_int);
+    
+    bool sorted = ll_size(list4) == 200;
+    
+    for(struct Node* ite = list4->first; ite && ite->next; ite = ite->next)
+        sorted = sorted && compare_int(ite->value, ite->next->value) <= 0 && ite->next->previous == ite;
+    
+    printf("%s\n", sorted ? "sorted" : "NOT SORTED");
+    
+    printf("Sorted list : inserting 1000 values, removing 100, merging... ");
+    
+    struct SortedList* sl = sl_create(compare_int);
+    struct SortedList* sl2 = sl_create(compare_int);
+    
+    for(int i = 0; i < 1000; ++i)
+        sl_insert(sl, new_int((i * 7919) % 1000));
+    
+    for(int i = 0; i < 100; ++i)
+        sl_remove(sl, &i);
+    
+    for(int i = 0; i < 50; ++i)
+        sl_insert(sl2, new_int(i * 20));
+    
+    sl_merge(sl, sl2);
+    
+    int absent = 50;
+    int present = 500;
+    sorted = sl_size(sl) == 950 && sl_size(sl2) == 0 && !sl_contains(sl, &absent) && sl_contains(sl, &present);
+    
+    for(struct Node* ite = sl->list->first; ite && ite->next; ite = ite->next)
+        sorted = sorted && compare_int(ite->value, ite->next->value) <= 0;
+    
+    printf("%s\n", sorted ? "ok" : "FAILED");
+    
+    printf("Inserting 1000 values at once in the middle of the sorted list... ");
+    
+    void* values[1000];
+    
+    for(int i = 0; i < 1000; ++i)
+        values[i] = new_int(-i);
+    
+    size_t size = ll_size(list4);
+    ll_insert_range(list4, 100, values, 1000);
+    
+    bool inserted = ll_size(list4) == size + 1000 && *((int*) ll_get(list4, 100)) == 0
+        && *((int*) ll_get(list4, 1099)) == -999 && *((int*) ll_last(list4)) == 210;
+    
+    for(struct Node* ite = list4->first; ite && ite->next; ite = ite->next)
+        inserted = inserted && ite->next->previous == ite;
+    
+    printf("%s\n", inserted ? "ok" : "FAILED");
+    
+    printf("Killing every other element of a list of 1000 values... ");
+    
+    struct LinkedList* list5 = ll_create();
+    struct Node* nodes[1000];
+    
+    ll_set_compaction_threshold(list5, 0.6);
+    
+    for(int i = 0; i < 1000; ++i)
+        nodes[i] = ll_insert_after(list5, list5->last, new_int(i));
+    
+    // Kill the even values from the end: 500 kills stay below the threshold
+    for(int i = 998; i >= 0; i -= 2)
+        ll_kill(list5, nodes[i]);
+    
+    // ll_first unlinks the killed head, indexed accesses skip the others without compacting
+    bool lazy = ll_size(list5) == 500 && ll_dead_count(list5) == 500 && *((int*) ll_first(list5)) == 1
+        && *((int*) ll_get(list5, 499)) == 999 && *((int*) ll_get(list5, 125)) == 251
+        && ll_dead_count(list5) == 499;
+    
+    ll_swap(list5, 0, 499);
+    ll_remove_at(list5, 250);
+    lazy = lazy && *((int*) ll_get(list5, 0)) == 999 && *((int*) ll_get(list5, 250)) == 503
+        && ll_size(list5) == 499 && ll_dead_count(list5) == 499;
+    
+    ll_compact(list5);
+    lazy = lazy && ll_dead_count(list5) == 0 && list5->length == 499;
+    
+    printf("%s\n", lazy ? "ok" : "FAILED");
+    
+    ll_destroy(list5);
+    
+    printf("Small lists use the nodes stored in the structure... ");
+    
+    struct LinkedList* small = ll_create();
+    struct LinkedList* small2 = ll_create();
+    
+    for(int i = 0; i < LL_SMALL_NODES; ++i) {
+        ll_push_back(small, new_int(2 * i));
+        ll_push_back(small2, new_int(2 * i + 1));
+    }
+    
+    bool inline_nodes = small->blocks == NULL && small2->blocks == NULL;
+    
+    // small takes the nodes of small2, which must not stay in small2's structure
+    ll_merge(small, small2, compare_int);
+    ll_destroy(small2);
+    
+    for(int i = 0; i < 2 * LL_SMALL_NODES; ++i)
+        inline_nodes = inline_nodes && *((int*) ll_get(small, i)) == i;
+    
+    printf("%s\n", inline_nodes && small->blocks != NULL ? "ok" : "FAILED");
+    
+    ll_destroy(small);
+    
+    printf("List on the stack... ");
+    
+    struct LinkedList stack_list;
+    
+    ll_init(&stack_list);
+    
+    for(int i = 0; i < 100; ++i)
+        ll_push_back(&stack_list, new_int(i));
+    
+    printf("%s\n", ll_size(&stack_list) == 100 && *((int*) ll_last(&stack_list)) == 99 ? "ok" : "FAILED");
+    
+    ll_fini(&stack_list);
+    
+    printf("Pool list : inserting 1000 values out of order, removing some, compacting... ");
+    
+    struct PoolList* pool = pl_create();
+    uint32_t slots[1000];
+    int order[751];
+    
+    // Odd values at the front, even ones at the back: the list order is not the slot order
+    for(int i = 0; i < 1000; ++i)
+        slots[i] = (i % 2) ? pl_push_front(pool, new_int(i)) : pl_push_back(pool, new_int(i));
+    
+    for(int i = 0; i < 1000; i += 4)
+        pl_remove(pool, slots[i]);
+    
+    // The removed slots are recycled before the array grows
+    pl_insert_after(pool, slots[1], new_int(-1));
+    
+    bool pooled = pl_size(pool) == 751 && pool->used == 1000 && *((int*) pl_get(pool, 500)) == -1;
+    uint32_t slot = 0;
+    
+    for(uint32_t ite = pl_first(pool); ite != PL_NONE; ite = pl_next(pool, ite))
+        order[slot++] = *((int*) pl_value(pool, ite));
+    
+    pl_compact(pool);
+    slot = 0;
+    
+    for(uint32_t ite = pl_first(pool); ite != PL_NONE; ite = pl_next(pool, ite), ++slot)
+        pooled = pooled && ite == slot && *((int*) pl_value(pool, ite)) == order[slot];
+    
+    printf("%s\n", pooled && slot == 751 && pool->capacity == 751 && pl_last(pool) == 750 ? "ok" : "FAILED");
+    
+    pl_destroy(pool);
+    
+    printf("Generic list of ints... ");
+    
+    IntList ints;
+    
+    IntList_init(&ints);
+    
+    for(int i = 0; i < 100; ++i)
+        IntList_push_back(&ints, i);
+    
+    IntList_push_front(&ints, -1);
+    
+    bool typed = IntList_pop_front(&ints) == -1 && IntList_pop_back(&ints) == 99 && IntList_size(&ints) == 99
+        && IntList_get(&ints, 60) == 60 && IntList_contains(&ints, 42) && !IntList_contains(&ints, 99);
+    
+    // The two removed nodes are reused
+    IntList_push_back(&ints, 100);
+    IntList_push_back(&ints, 101);
+    
+    printf("%s\n", typed && ints.free_nodes == NULL && IntList_last(&ints) == 101 ? "ok" : "FAILED");
+    
+    IntList_fini(&ints);
+    
+    printf("Immutable list : versions share their nodes, snapshots are read by 4 threads... ");
+    
+    struct ImmutableList* version = NULL;
+    
+    for(int i = 0; i < 1000; ++i) {
+        struct ImmutableList* tmp = il_push_front(version, new_int(i));
+        il_release(version);
+        version = tmp;
+    }
+    
+    struct ImmutableList* popped = il_pop_front(version);
+    struct ImmutableList* pushed = il_push_front(popped, new_int(-1));
+    
+    bool versions = il_size(version) == 1000 && *((int*) il_first(version)) == 999
+        && il_size(pushed) == 1000 && *((int*) il_first(pushed)) == -1 && pushed->next == version->next
+        && *((int*) il_get(popped, 998)) == 0 && version->next->references == 3;
+    
+    struct Reader readers[4];
+    pthread_t threads[4];
+    
+    for(int i = 0; i < 4; ++i) {
+        readers[i].snapshot = il_retain(i % 2 ? version : pushed);
+        pthread_create(&threads[i], NULL, read_snapshot, &readers[i]);
+    }
+    
+    // The writer goes on while the readers work on their snapshots
+    il_release(popped);
+    il_release(version);
+    
+    for(int i = 0; i < 4; ++i) {
+        pthread_join(threads[i], NULL);
+        versions = versions && readers[i].sum == (i % 2 ? 999 * 1000 / 2 : 998 * 999 / 2 - 1);
+    }
+    
+    printf("%s\n", versions && pushed->references == 1 && pushed->next->references == 1 ? "ok" : "FAILED");
+    
+    il_release(pushed);
+    
+    printf("Reset keeps the nodes, lists of the same shape are recycled... ");
+    
+    struct LinkedList* reused = ll_create();
+    
+    for(int i = 0; i < 1000; ++i)
+        ll_push_back(reused, new_int(i));
+    
+    struct ll_block* blocks = reused->blocks;
+    
+    ll_reset(reused);
+    
+    for(int i = 0; i < 1000; ++i)
+        ll_push_front(reused, new_int(i));
+    
+    bool kept = reused->blocks == blocks && ll_size(reused) == 1000 && *((int*) ll_first(reused)) == 999;
+    
+    ll_destroy(reused);
+    
+    // After the first round, the structures and blocks come from the cache
+    struct recyclage_stats before, after;
+    
+    for(int round = 0; round < 101; ++round) {
+        if(round == 1)
+            Recyclage_statistiques(&before);
+        
+        reused = ll_create();
+        
+        for(int i = 0; i < 1000; ++i)
+            ll_push_back(reused, new_int(i));
+        
+        ll_destroy(reused);
+    }
+    
+    Recyclage_statistiques(&after);
+    
+    printf("%s\n", kept && after.prises - before.prises == after.reutilisees - before.reutilisees ? "ok" : "FAILED");
+    
+    ll_destroy(list4);
+    sl_destroy(sl);
+    sl_destroy(sl2);
 
     printf("Ending software\n");
     
     return (EXIT_SUCCESS);
 }
-
-
@@ -0,0 +1,671 @@
+/**
+ * \file bench.c
+ * \author Zevio.S et Benharchache.S
+ * \brief Mesures de performance du tas et de la liste chainee
+ * \date 18 decembre 2014
+ *
+ * Ecrit une ligne CSV par mesure sur la sortie standard :
+ * conteneur,operation,motif,n,ops,secondes,ns_par_op
+ *
+ * Usage : bench [n_max]   (n va de 1e3 a n_max par puissances de 10, 1e6 par defaut)
+ *
+ * Les operations en O(n) par appel (get, insert, contains)
+ * ne sont appelees qu'un nombre limite de fois pour que chaque mesure reste courte.
+ *
+ * Pour la file partagee, les lignes de compteurs (extractions_distantes,
+ * contentions...) donnent dans ops le nombre d'evenements pendant la mesure.
+ * Pour l'etage de pipeline, les lignes latence_p50 et latence_p99 ont ops = 1 :
+ * ns_par_op est la latence entre l'envoi d'une valeur et sa sortie.
+ * Pour le tas grand, les lignes defauts_pages_* et tlb_* sont aussi des
+ * compteurs ; tlb_* n'apparait que si le noyau donne acces au compteur de
+ * defauts de TLB des donnees (perf_event_open).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE // syscall
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#endif
+
+#include "Heap.h"
+#include "TasExterne.h"
+#include "TasPartage.h"
+#include "TasPipeline.h"
+#include "TasGenerique.h"
+#include "autres/ImmutableList.h"
+#include "autres/LinkedList.h"
+#include "autres/PoolList.h"
+
+// Nombre maximal d'elements parcourus par une mesure d'operation en O(n)
+#define BENCH_BUDGET 5000000ULL
+
+// Les resultats y sont accumules pour que le compilateur ne supprime pas les appels
+static volatile uintptr_t puits;
+
+enum motif{ UNIFORME, TRIE, INVERSE, ADVERSE, NB_MOTIFS };
+static const char* noms_motifs[NB_MOTIFS] = { "uniforme", "trie", "inverse", "adverse" };
+
+static double horloge(void){
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+// Generateur xorshift : reproductible et sans appel a rand()
+static uint64_t graine = 88172645463325252ULL;
+static uint64_t aleatoire(void){
+	graine ^= graine << 13;
+	graine ^= graine >> 7;
+	graine ^= graine << 17;
+	return graine;
+}
+
+// Remplit cles selon le motif. Le motif adverse alterne petites et grandes
+// cles : chaque petite cle remonte jusqu'a la racine du tas.
+static void generer(intptr_t* cles, size_t n, enum motif m){
+	for(size_t i = 0; i < n; i++){
+		switch(m){
+		case UNIFORME: cles[i] = (intptr_t)(aleatoire() % (n*4)); break;
+		case TRIE: cles[i] = (intptr_t)i; break;
+		case INVERSE: cles[i] = (intptr_t)(n-i); break;
+		default: cles[i] = (i & 1) ? (intptr_t)(n+i) : (intptr_t)(n-i); break;
+		}
+	}
+}
+
+static void ligne(const char* conteneur, const char* operation, enum motif m, size_t n, size_t ops, double secondes){
+	printf("%s,%s,%s,%zu,%zu,%.6f,%.2f\n", conteneur, operation, noms_motifs[m], n, ops, secondes,
+		ops ? secondes*1e9/ops : 0.0);
+}
+
+// Nombre d'appels d'une operation en O(n) pour rester dans le budget
+static size_t ops_limitees(size_t n){
+	size_t ops = (size_t)(BENCH_BUDGET / n);
+	if(ops > n)
+		ops = n;
+	return ops ? ops : 1;
+}
+
+static Heap tas_rempli(const intptr_t* cles, size_t n){
+	Heap h = Tas_creer(0);
+	Tas_fixer_comparateur(h, Tas_comparer_entiers);
+	for(size_t i = 0; i < n; i++)
+		Tas_ajouter_valeur(h, (void*)cles[i]);
+	return h;
+}
+
+// Meme tas que Heap, mais type : la comparaison est integree dans les tamisages
+DEFINE_HEAP(TasCles, intptr_t, TAS_CMP_NATUREL)
+
+static void bench_tas_generique(const intptr_t* cles, size_t n, enum motif m){
+	double t;
+	TasCles h;
+
+	TasCles_initialiser(&h);
+	t = horloge();
+	for(size_t i = 0; i < n; i++)
+		TasCles_ajouter(&h, cles[i]);
+	ligne("tas_generique", "push", m, n, n, horloge()-t);
+
+	t = horloge();
+	while(!TasCles_estVide(&h))
+		puits += (uintptr_t)TasCles_extraire(&h);
+	ligne("tas_generique", "pop", m, n, n, horloge()-t);
+	TasCles_finaliser(&h);
+}
+
+static void bench_tas(const intptr_t* cles, size_t n, enum motif m){
+	double t;
+	Heap h, h2;
+
+	t = horloge();
+	h = tas_rempli(cles, n);
+	ligne("tas", "push", m, n, n, horloge()-t);
+
+	t = horloge();
+	while(!Tas_estVide(h))
+		puits += (uintptr_t)Tas_extraire(h);
+	ligne("tas", "pop", m, n, n, horloge()-t);
+	h = Tas_detruire(h);
+
+	// Tas min-max : on retire alternativement par les deux bouts
+	h = tas_rempli(cles, n);
+	Tas_fixer_minmax(h, 1);
+	t = horloge();
+	for(size_t i = 0; !Tas_estVide(h); i++)
+		puits += (uintptr_t)((i & 1) ? Tas_extraire_max(h) : Tas_extraire_min(h));
+	ligne("tas", "pop_minmax", m, n, n, horloge()-t);
+	h = Tas_detruire(h);
+
+	h = tas_rempli(cles, n/2);
+	h2 = tas_rempli(cles + n/2, n - n/2);
+	t = horloge();
+	h = Tas_concatener(h, h2);
+	ligne("tas", "merge", m, n, n - n/2, horloge()-t);
+	h2 = Tas_detruire(h2);
+
+	size_t ops = ops_limitees(n);
+	t = horloge();
+	for(size_t i = 0; i < ops && !Tas_estVide(h); i++){
+		Heap r = Tas_enlever_valeur(aleatoire() % Tas_taille(h), h);
+		if(r != h)
+			Tas_detruire(h);
+		h = r;
+	}
+	ligne("tas", "remove", m, n, ops, horloge()-t);
+	h = Tas_detruire(h);
+
+	// File externe avec 1 Mio de memoire
+	TasExterne te = TasExterne_creer(Tas_comparer_entiers, 1 << 20);
+	t = horloge();
+	for(size_t i = 0; i < n; i++)
+		TasExterne_ajouter(te, (void*)cles[i]);
+	while(!TasExterne_estVide(te))
+		puits += (uintptr_t)TasExterne_extraire(te);
+	ligne("tas", "externe_push_pop", m, n, n, horloge()-t);
+	te = TasExterne_detruire(te);
+
+	// Selection des 100 plus grandes cles dans un tas borne
+	h = Tas_creerBorne(100, Tas_comparer_entiers);
+	t = horloge();
+	for(size_t i = 0; i < n; i++)
+		Tas_proposer(h, (void*)cles[i], NULL);
+	ligne("tas", "top100", m, n, n, horloge()-t);
+	h = Tas_detruire(h);
+
+	t = horloge();
+	h = Tas_selectionner((void**)cles, n, 100, Tas_comparer_entiers, 4);
+	ligne("tas", "top100_4fils", m, n, n, horloge()-t);
+	h = Tas_detruire(h);
+
+	// Recherche d'une cle absente (parcours complet) et suppression groupee
+	h = tas_rempli(cles, n);
+	ops = ops_limitees(n);
+	t = horloge();
+	for(size_t i = 0; i < ops; i++)
+		puits += Tas_trouver(h, (void*)(intptr_t)-1);
+	ligne("tas", "trouver", m, n, ops, horloge()-t);
+	t = horloge();
+	puits += Tas_supprimer_egaux(h, (void*)cles[0]);
+	ligne("tas", "supprimer_egaux", m, n, 1, horloge()-t);
+	h = Tas_detruire(h);
+
+	// Suppression paresseuse : compactage amorti au seuil par defaut
+	h = tas_rempli(cles, n);
+	t = horloge();
+	for(size_t i = 0; i < n/2; i++)
+		Tas_marquer_mort(h, aleatoire() % Tas_taille(h));
+	ligne("tas", "marquer_mort", m, n, n/2, horloge()-t);
+	h = Tas_detruire(h);
+}
+
+// File partagee : chaque fil ajoute sa part des cles puis en extrait autant
+#define BENCH_FILS 4
+
+struct bench_fil{
+	TasPartage t;
+	const intptr_t* cles;
+	size_t n;
+};
+
+static void* bench_fil_partage(void* arg){
+	struct bench_fil* f = arg;
+	void* v;
+	for(size_t i = 0; i < f->n; i++)
+		TasPartage_ajouter(f->t, (void*)f->cles[i]);
+	for(size_t i = 0; i < f->n && TasPartage_extraire(f->t, &v); i++)
+		puits += (uintptr_t)v;
+	return NULL;
+}
+
+static void bench_partage(const intptr_t* cles, size_t n, enum motif m, unsigned par_noeud){
+	char nom[32];
+	struct bench_fil f[BENCH_FILS];
+	pthread_t fils[BENCH_FILS];
+	struct tas_partage_stats stats;
+	TasPartage t = TasPartage_creer(Tas_comparer_entiers, par_noeud);
+	double d = horloge();
+
+	for(int i = 0; i < BENCH_FILS; i++){
+		f[i].t = t;
+		f[i].cles = cles + i*(n/BENCH_FILS);
+		f[i].n = n/BENCH_FILS;
+		pthread_create(&fils[i], NULL, bench_fil_partage, &f[i]);
+	}
+	for(int i = 0; i < BENCH_FILS; i++)
+		pthread_join(fils[i], NULL);
+	d = horloge()-d;
+
+	TasPartage_statistiques(t, &stats);
+	snprintf(nom, sizeof(nom), "tas_partage_%u", par_noeud);
+	ligne(nom, "push_pop_4fils", m, n, 2*(n/BENCH_FILS)*BENCH_FILS, d);
+	ligne(nom, "extractions_voisines", m, n, stats.extractions_voisines, d);
+	ligne(nom, "extractions_distantes", m, n, stats.extractions_distantes, d);
+	ligne(nom, "tranches_vides", m, n, stats.tranches_vides, d);
+	ligne(nom, "contentions", m, n, stats.contentions, d);
+	t = TasPartage_detruire(t);
+}
+
+// Etage de pipeline : un fil producteur, la sortie sur le fil principal.
+// Chaque valeur pointe sur sa cle et sur l'heure de son envoi.
+#define BENCH_LOT 64
+
+struct mesure{
+	intptr_t cle;
+	double envoi;
+};
+
+static int comparer_mesures(const void* a, const void* b){
+	intptr_t x = ((const struct mesure*)a)->cle, y = ((const struct mesure*)b)->cle;
+	return (x > y) - (x < y);
+}
+
+static int comparer_doubles(const void* a, const void* b){
+	double x = *(const double*)a, y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+// Ce que l'etage remplace : un verrou et un reveil par valeur autour d'un Heap
+struct file_naive{
+	pthread_mutex_t verrou;
+	pthread_cond_t pret;
+	Heap h;
+	int ferme;
+};
+
+struct bench_production{
+	struct mesure* mesures;
+	size_t n;
+	TasPipeline p;			// NULL pour la file naive
+	struct file_naive* naive;
+};
+
+static void* bench_produire(void* arg){
+	struct bench_production* b = arg;
+	void* lot[BENCH_LOT];
+	size_t k = 0;
+
+	for(size_t i = 0; i < b->n; i++){
+		b->mesures[i].envoi = horloge();
+		if(b->p != NULL){
+			lot[k++] = &b->mesures[i];
+			if(k == BENCH_LOT || i+1 == b->n){
+				TasPipeline_envoyer_lot(b->p, lot, k);
+				k = 0;
+			}
+		}
+		else{
+			pthread_mutex_lock(&b->naive->verrou);
+			Tas_ajouter_valeur(b->naive->h, &b->mesures[i]);
+			pthread_cond_signal(&b->naive->pret);
+			pthread_mutex_unlock(&b->naive->verrou);
+		}
+	}
+	if(b->p != NULL)
+		TasPipeline_fermer(b->p);
+	else{
+		pthread_mutex_lock(&b->naive->verrou);
+		b->naive->ferme = 1;
+		pthread_cond_signal(&b->naive->pret);
+		pthread_mutex_unlock(&b->naive->verrou);
+	}
+	return NULL;
+}
+
+// Recoit une valeur de la file naive, 0 quand elle est fermee et vide
+static size_t recevoir_naive(struct file_naive* f, void** sortie){
+	size_t n = 0;
+	pthread_mutex_lock(&f->verrou);
+	while(Tas_estVide(f->h) && !f->ferme)
+		pthread_cond_wait(&f->pret, &f->verrou);
+	if(!Tas_estVide(f->h))
+		sortie[n++] = Tas_extraire(f->h);
+	pthread_mutex_unlock(&f->verrou);
+	return n;
+}
+
+static void bench_pipeline(const intptr_t* cles, size_t n, enum motif m, int naive){
+	const char* nom = naive ? "file_naive" : "pipeline";
+	struct mesure* mesures = malloc(n * sizeof(struct mesure));
+	double* latences = malloc(n * sizeof(double));
+	void* sortie[BENCH_LOT];
+	struct file_naive f;
+	struct bench_production b = { mesures, n, NULL, &f };
+	pthread_t producteur;
+	size_t recus, nb = 0;
+	double t;
+
+	for(size_t i = 0; i < n; i++)
+		mesures[i].cle = cles[i];
+	if(naive){
+		pthread_mutex_init(&f.verrou, NULL);
+		pthread_cond_init(&f.pret, NULL);
+		f.h = Tas_creer(0);
+		Tas_fixer_comparateur(f.h, comparer_mesures);
+		f.ferme = 0;
+	}
+	else
+		b.p = TasPipeline_creer(comparer_mesures, 1024, 2048, 4096);
+
+	t = horloge();
+	pthread_create(&producteur, NULL, bench_produire, &b);
+	while((recus = naive ? recevoir_naive(&f, sortie) : TasPipeline_recevoir_lot(b.p, sortie, BENCH_LOT)) > 0){
+		double maintenant = horloge();
+		for(size_t i = 0; i < recus && nb < n; i++)
+			latences[nb++] = maintenant - ((struct mesure*)sortie[i])->envoi;
+	}
+	pthread_join(producteur, NULL);
+	t = horloge()-t;
+
+	qsort(latences, nb, sizeof(double), comparer_doubles);
+	ligne(nom, "debit", m, n, n, t);
+	ligne(nom, "latence_p50", m, n, 1, latences[nb/2]);
+	ligne(nom, "latence_p99", m, n, 1, latences[nb*99/100]);
+
+	if(naive){
+		f.h = Tas_detruire(f.h);
+		pthread_cond_destroy(&f.pret);
+		pthread_mutex_destroy(&f.verrou);
+	}
+	else
+		b.p = TasPipeline_detruire(b.p);
+	free(latences);
+	free(mesures);
+}
+
+// Valeur de liste : la liste libere ses valeurs, il faut donc les allouer.
+// ll_contains compare sizeof(void*) octets, d'ou un intptr_t.
+static void* valeur(intptr_t cle){
+	intptr_t* v = malloc(sizeof(intptr_t));
+	if(v == NULL)
+		exit(1);
+	*v = cle;
+	return v;
+}
+
+static struct LinkedList* liste_remplie(const intptr_t* cles, size_t n){
+	struct LinkedList* l = ll_create();
+	for(size_t i = n; i-- > 0; )
+		ll_push_front(l, valeur(cles[i]));
+	return l;
+}
+
+static void bench_liste(const intptr_t* cles, size_t n, enum motif m){
+	double t;
+	size_t ops = ops_limitees(n);
+	struct LinkedList* l;
+
+	t = horloge();
+	l = liste_remplie(cles, n);
+	ligne("liste", "push_front", m, n, n, horloge()-t);
+
+	t = horloge();
+	for(size_t i = 0; i < n; i++)
+		ll_push_back(l, valeur(cles[i]));
+	ligne("liste", "push_back", m, n, n, horloge()-t);
+
+	t = horloge();
+	for(size_t i = 0; i < ops; i++)
+		puits += (uintptr_t)ll_get(l, aleatoire() % ll_size(l));
+	ligne("liste", "get", m, n, ops, horloge()-t);
+
+	t = horloge();
+	for(size_t i = 0; i < ops; i++)
+		ll_insert(l, aleatoire() % ll_size(l), valeur(cles[i]), 1);
+	ligne("liste", "insert", m, n, ops, horloge()-t);
+
+	intptr_t cherche;
+	t = horloge();
+	for(size_t i = 0; i < ops; i++){
+		cherche = cles[aleatoire() % n];
+		puits += ll_contains(l, &cherche);
+	}
+	ligne("liste", "contains", m, n, ops, horloge()-t);
+
+	void** valeurs = malloc(n * sizeof(void*));
+	for(size_t i = 0; i < n; i++)
+		valeurs[i] = valeur(cles[i]);
+	t = horloge();
+	ll_insert_range(l, ll_size(l)/2, valeurs, n);
+	ligne("liste", "insert_range", m, n, n, horloge()-t);
+	free(valeurs);
+
+	t = horloge();
+	for(struct Node* ite = l->first; ite != NULL; ite = ite->next)
+		puits += *(intptr_t*)ite->value;
+	ligne("liste", "parcours", m, n, l->length, horloge()-t);
+
+	t = horloge();
+	struct LinkedList* copie = ll_clone(l);
+	ligne("liste", "clone", m, n, ll_size(l), horloge()-t);
+	ll_destroy(copie);
+
+	// Liste immuable : un instantane remplace le clone
+	struct ImmutableList* version = NULL;
+	t = horloge();
+	for(size_t i = 0; i < n; i++){
+		struct ImmutableList* suivante = il_push_front(version, valeur(cles[i]));
+		il_release(version);
+		version = suivante;
+	}
+	ligne("liste_immuable", "push_front", m, n, n, horloge()-t);
+	t = horloge();
+	for(size_t i = 0; i < n; i++)
+		il_release(il_retain(version));
+	ligne("liste_immuable", "snapshot", m, n, n, horloge()-t);
+	t = horloge();
+	while(version != NULL){
+		struct ImmutableList* suivante = il_pop_front(version);
+		il_release(version);
+		version = suivante;
+	}
+	ligne("liste_immuable", "pop_front", m, n, n, horloge()-t);
+
+	struct LinkedList* tues = ll_create();
+	struct Node** noeuds = malloc(n * sizeof(struct Node*));
+	for(size_t i = 0; i < n; i++)
+		noeuds[i] = ll_insert_after(tues, tues->last, valeur(cles[i]));
+	t = horloge();
+	for(size_t i = 0; i < n; i += 2)
+		ll_kill(tues, noeuds[i]);
+	ligne("liste", "kill", m, n, (n+1)/2, horloge()-t);
+	free(noeuds);
+	ll_destroy(tues);
+
+	ll_destroy(l);
+}
+
+// Boucle de requetes : n cles traitees par conteneurs de BENCH_CYCLE elements, detruits
+// et recrees a chaque tour (structures et blocs recycles par le cache) ou vides et reutilises
+#define BENCH_CYCLE 1000
+
+static void bench_cycles(const intptr_t* cles, size_t n, enum motif m){
+	double t;
+	size_t tours = (n + BENCH_CYCLE - 1) / BENCH_CYCLE;
+	size_t k = (n < BENCH_CYCLE) ? n : BENCH_CYCLE;
+
+	t = horloge();
+	for(size_t c = 0; c < tours; c++){
+		Heap h = tas_rempli(cles + c*k % (n - k + 1), k);
+		puits += (uintptr_t)Tas_sommet(h);
+		Tas_detruire(h);
+	}
+	ligne("tas", "cycle_detruire", m, n, tours*k, horloge()-t);
+
+	Heap h = Tas_creer(0);
+	Tas_fixer_comparateur(h, Tas_comparer_entiers);
+	t = horloge();
+	for(size_t c = 0; c < tours; c++){
+		const intptr_t* lot = cles + c*k % (n - k + 1);
+		for(size_t i = 0; i < k; i++)
+			Tas_ajouter_valeur(h, (void*)lot[i]);
+		puits += (uintptr_t)Tas_sommet(h);
+		Tas_vider(h);
+	}
+	ligne("tas", "cycle_vider", m, n, tours*k, horloge()-t);
+	Tas_detruire(h);
+
+	t = horloge();
+	for(size_t c = 0; c < tours; c++){
+		struct LinkedList* l = ll_create();
+		for(size_t i = 0; i < k; i++)
+			ll_push_back(l, valeur(cles[i]));
+		ll_destroy(l);
+	}
+	ligne("liste", "cycle_detruire", m, n, tours*k, horloge()-t);
+
+	struct LinkedList* l = ll_create();
+	t = horloge();
+	for(size_t c = 0; c < tours; c++){
+		for(size_t i = 0; i < k; i++)
+			ll_push_back(l, valeur(cles[i]));
+		ll_reset(l);
+	}
+	ligne("liste", "cycle_reset", m, n, tours*k, horloge()-t);
+	ll_destroy(l);
+}
+
+// Defauts de page du processus et defauts de TLB des donnees (tlb < 0 si
+// le compteur n'est pas disponible, par exemple dans une machine virtuelle)
+struct compteurs{
+	long defauts;
+	long long tlb;
+};
+
+static int tlb_fd = -2;	// -2 tant que le compteur n'a pas ete ouvert
+
+static void compteurs_lire(struct compteurs* c){
+	struct rusage r;
+	getrusage(RUSAGE_SELF, &r);
+	c->defauts = r.ru_minflt + r.ru_majflt;
+	c->tlb = -1;
+#ifdef __linux__
+	if(tlb_fd == -2){
+		struct perf_event_attr a;
+		memset(&a, 0, sizeof(a));
+		a.size = sizeof(a);
+		a.type = PERF_TYPE_HW_CACHE;
+		a.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		a.exclude_kernel = 1;
+		a.exclude_hv = 1;
+		tlb_fd = (int)syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+	}
+	uint64_t v;
+	if(tlb_fd >= 0 && read(tlb_fd, &v, sizeof(v)) == (ssize_t)sizeof(v))
+		c->tlb = (long long)v;
+#endif
+}
+
+static void lignes_compteurs(const char* conteneur, const char* operation, enum motif m, size_t n,
+		const struct compteurs* avant, const struct compteurs* apres, double secondes){
+	char nom[32];
+	snprintf(nom, sizeof(nom), "defauts_pages_%s", operation);
+	ligne(conteneur, nom, m, n, (size_t)(apres->defauts - avant->defauts), secondes);
+	if(avant->tlb >= 0 && apres->tlb >= 0){
+		snprintf(nom, sizeof(nom), "tlb_%s", operation);
+		ligne(conteneur, nom, m, n, (size_t)(apres->tlb - avant->tlb), secondes);
+	}
+}
+
+// Tas dont le tableau grandit par realloc (Tas_creer), puis reserve d'avance
+// en pages geantes (Tas_creerGrand). Les deux descendent avec prechargement.
+static void bench_grand(const intptr_t* cles, size_t n, enum motif m){
+	struct compteurs avant, apres;
+	double t;
+
+	for(int grand = 0; grand < 2; grand++){
+		const char* nom = grand ? "tas_grand" : "tas_realloc";
+
+		compteurs_lire(&avant);
+		t = horloge();
+		Heap h = grand ? Tas_creerGrand(n) : Tas_creer(0);
+		Tas_fixer_comparateur(h, Tas_comparer_entiers);
+		for(size_t i = 0; i < n; i++)
+			Tas_ajouter_valeur(h, (void*)cles[i]);
+		t = horloge()-t;
+		compteurs_lire(&apres);
+		ligne(nom, "push", m, n, n, t);
+		lignes_compteurs(nom, "push", m, n, &avant, &apres, t);
+
+		compteurs_lire(&avant);
+		t = horloge();
+		while(!Tas_estVide(h))
+			puits += (uintptr_t)Tas_extraire(h);
+		t = horloge()-t;
+		compteurs_lire(&apres);
+		ligne(nom, "pop", m, n, n, t);
+		lignes_compteurs(nom, "pop", m, n, &avant, &apres, t);
+		h = Tas_detruire(h);
+	}
+}
+
+// Liste dans un tableau : insertions a des places aleatoires, puis parcours avant et apres pl_compact
+static void bench_pool(const intptr_t* cles, size_t n, enum motif m){
+	double t;
+	struct PoolList* p = pl_create();
+	uint32_t* places = malloc(n * sizeof(uint32_t));
+
+	t = horloge();
+	places[0] = pl_push_back(p, valeur(cles[0]));
+	for(size_t i = 1; i < n; i++)
+		places[i] = pl_insert_after(p, places[aleatoire() % i], valeur(cles[i]));
+	ligne("liste_pool", "insert_after", m, n, n, horloge()-t);
+
+	t = horloge();
+	for(uint32_t ite = pl_first(p); ite != PL_NONE; ite = pl_next(p, ite))
+		puits += *(intptr_t*)pl_value(p, ite);
+	ligne("liste_pool", "parcours", m, n, n, horloge()-t);
+
+	t = horloge();
+	pl_compact(p);
+	ligne("liste_pool", "compact", m, n, n, horloge()-t);
+
+	t = horloge();
+	for(uint32_t ite = pl_first(p); ite != PL_NONE; ite = pl_next(p, ite))
+		puits += *(intptr_t*)pl_value(p, ite);
+	ligne("liste_pool", "parcours_compact", m, n, n, horloge()-t);
+
+	free(places);
+	pl_destroy(p);
+}
+
+int main(int argc, char** argv){
+	size_t n_max = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000;
+	intptr_t* cles;
+
+	if((cles = malloc(n_max * sizeof(intptr_t))) == NULL){
+		fprintf(stderr, "pas assez de memoire pour %zu cles\n", n_max);
+		return 1;
+	}
+
+	printf("conteneur,operation,motif,n,ops,secondes,ns_par_op\n");
+	for(size_t n = 1000; n <= n_max; n *= 10){
+		for(int m = 0; m < NB_MOTIFS; m++){
+			generer(cles, n, m);
+			bench_tas(cles, n, m);
+			bench_grand(cles, n, m);
+			bench_tas_generique(cles, n, m);
+			bench_partage(cles, n, m, 1);
+			bench_partage(cles, n, m, BENCH_FILS);
+			bench_pipeline(cles, n, m, 1);
+			bench_pipeline(cles, n, m, 0);
+			bench_liste(cles, n, m);
+			bench_pool(cles, n, m);
+			bench_cycles(cles, n, m);
+			fflush(stdout);
+		}
+	}
+
+	free(cles);
+	return 0;
+}
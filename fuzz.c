@@ -0,0 +1,526 @@
+/**
+ * \file fuzz.c
+ * \author Zevio.S et Benharchache.S
+ * \brief Test differentiel du tas et de la liste contre des modeles simples
+ * \date 18 decembre 2014
+ *
+ * Une entree est une suite d'octets lue comme une suite d'operations : un
+ * octet choisit l'operation, les suivants ses arguments. La meme entree est
+ * rejouee sur un Heap et sur une LinkedList ; apres chaque operation leur
+ * contenu est compare a un simple tableau. Toute difference appelle abort(),
+ * ce que libFuzzer et AFL prennent pour un plantage.
+ *
+ * Compile avec BIBLISD_INSTRUMENTATION, le test verifie aussi des budgets
+ * de complexite a partir des compteurs de Instrumentation.h : comparaisons
+ * par ajout ou extraction, pas de parcours par acces, reallocations.
+ *
+ * make fuzz      : version autonome, avec ASan et UBSan
+ *   ./fuzz                 rejoue FUZZ_NB_SUITES suites aleatoires
+ *   ./fuzz fichier...      rejoue des fichiers (corpus AFL ou libFuzzer), - pour l'entree standard
+ * make fuzz_libfuzzer : point d'entree LLVMFuzzerTestOneInput pour clang -fsanitize=fuzzer
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Heap.h"
+#include "Instrumentation.h"
+#include "autres/LinkedList.h"
+
+// Taille maximale des conteneurs, pour que chaque suite reste rapide
+#define FUZZ_MAX 512
+// Nombre et taille maximale des suites aleatoires de la version autonome
+#define FUZZ_NB_SUITES 1000
+#define FUZZ_TAILLE 1024
+
+// Lecture des octets d'une entree, 0 quand elle est finie
+struct lecteur{
+	const uint8_t* donnees;
+	size_t taille;
+	size_t pos;
+};
+
+static unsigned octet(struct lecteur* l){
+	return (l->pos < l->taille) ? l->donnees[l->pos++] : 0;
+}
+
+static void echec(const char* conteneur, size_t pos, const char* message){
+	fprintf(stderr, "%s, octet %zu : %s\n", conteneur, pos, message);
+	abort();
+}
+
+#define VERIFIER(cond, conteneur, l, message) \
+	do{ if(!(cond)) echec(conteneur, (l)->pos, message); }while(0)
+
+// Plancher de log2(n+1) plus 1 : hauteur d'un tas de n valeurs
+static size_t hauteur(size_t n){
+	size_t h = 1;
+	while(n > 1){
+		n /= 2;
+		h++;
+	}
+	return h;
+}
+
+// Budgets de complexite : actifs seulement avec les compteurs
+#ifdef BIBLISD_INSTRUMENTATION
+#define FUZZ_BUDGETS 1
+#else
+#define FUZZ_BUDGETS 0
+#endif
+
+static struct instr_compteurs avant;
+
+static void mesurer(enum instr_conteneur c){
+	Instr_instantane(c, &avant);
+}
+
+static uint64_t depuis(enum instr_conteneur c, size_t champ){
+	struct instr_compteurs apres;
+	Instr_instantane(c, &apres);
+	return *(uint64_t*)((char*)&apres + champ) - *(uint64_t*)((char*)&avant + champ);
+}
+
+#define DEPUIS(c, champ) depuis(c, offsetof(struct instr_compteurs, champ))
+
+
+/* ---------- Tas ---------- */
+
+// Le modele du tas : les valeurs vivantes, dans le desordre
+struct modele{
+	intptr_t v[2*FUZZ_MAX];
+	size_t n;
+};
+
+static void modele_enlever(struct modele* m, intptr_t val){
+	for(size_t i = 0; i < m->n; i++){
+		if(m->v[i] == val){
+			m->v[i] = m->v[--m->n];
+			return;
+		}
+	}
+	abort();
+}
+
+static size_t modele_compter(const struct modele* m, intptr_t val){
+	size_t nb = 0;
+	for(size_t i = 0; i < m->n; i++)
+		nb += (m->v[i] == val);
+	return nb;
+}
+
+static intptr_t modele_min(const struct modele* m){
+	intptr_t min = m->v[0];
+	for(size_t i = 1; i < m->n; i++)
+		if(m->v[i] < min)
+			min = m->v[i];
+	return min;
+}
+
+static intptr_t modele_max(const struct modele* m){
+	intptr_t max = m->v[0];
+	for(size_t i = 1; i < m->n; i++)
+		if(m->v[i] > max)
+			max = m->v[i];
+	return max;
+}
+
+// Meme contenu (cases mortes exclues) et ordre de tas. Les valeurs sont
+// petites (un octet, plus 7 au plus) : on compte chaque valeur.
+#define FUZZ_VALEURS 512
+
+static void verifier_tas(Heap h, const struct modele* m, struct lecteur* l){
+	static long compte[FUZZ_VALEURS];
+
+	VERIFIER(Tas_taille(h) - Tas_nb_morts(h) == m->n, "tas", l, "nombre de valeurs");
+	VERIFIER(Tas_estVide(h) == (m->n == 0), "tas", l, "Tas_estVide");
+	memset(compte, 0, sizeof(compte));
+	for(size_t i = 0; i < m->n; i++)
+		compte[m->v[i]]++;
+	for(size_t i = 0; i < h->size; i++){
+		if(!h->minmax && i > 0)
+			VERIFIER(h->compare(h->heap[(i-1)/2], h->heap[i]) <= 0, "tas", l, "ordre du tas");
+		if(h->morts != NULL && h->morts[i])
+			continue;
+		intptr_t v = (intptr_t)h->heap[i];
+		VERIFIER(v >= 0 && v < FUZZ_VALEURS && compte[v]-- > 0, "tas", l, "valeur inconnue");
+	}
+}
+
+static void rejouer_tas(struct lecteur* l){
+	static struct modele m;
+	// Une suite sur deux joue le mode grand (tableau reserve par mmap)
+	Heap h = (l->taille & 1) ? Tas_creerGrand(1) : Tas_creer(0);
+	uint64_t reallocations_ajouts = 0;
+
+	Tas_fixer_comparateur(h, Tas_comparer_entiers);
+	m.n = 0;
+	l->pos = 0;
+	while(l->pos < l->taille){
+		unsigned op = octet(l) % 11;
+		intptr_t val = (intptr_t)octet(l);
+		size_t lg = hauteur(h->size + 1);
+		int sans_morts = (Tas_nb_morts(h) == 0);
+
+		switch(op){
+		case 0: // ajouter
+			if(m.n >= FUZZ_MAX)
+				break;
+			mesurer(INSTR_TAS);
+			Tas_ajouter_valeur(h, (void*)val);
+			m.v[m.n++] = val;
+			if(FUZZ_BUDGETS){
+				VERIFIER(DEPUIS(INSTR_TAS, comparaisons) <= 2*lg + 2, "tas", l, "budget de comparaisons d'un ajout");
+				VERIFIER(DEPUIS(INSTR_TAS, reallocations) <= 1, "tas", l, "budget de reallocations d'un ajout");
+				reallocations_ajouts += DEPUIS(INSTR_TAS, reallocations);
+			}
+			break;
+		case 1: // extraire le minimum
+			if(m.n == 0)
+				break;
+			mesurer(INSTR_TAS);
+			VERIFIER((intptr_t)Tas_extraire(h) == modele_min(&m), "tas", l, "Tas_extraire");
+			if(FUZZ_BUDGETS && sans_morts)
+				VERIFIER(DEPUIS(INSTR_TAS, comparaisons) <= 4*lg + 4, "tas", l, "budget de comparaisons d'une extraction");
+			modele_enlever(&m, modele_min(&m));
+			break;
+		case 2: // extraire le maximum, ou lire le sommet
+			if(m.n == 0)
+				break;
+			if(h->minmax){
+				VERIFIER((intptr_t)Tas_extraire_max(h) == modele_max(&m), "tas", l, "Tas_extraire_max");
+				modele_enlever(&m, modele_max(&m));
+			}
+			else
+				VERIFIER((intptr_t)Tas_sommet(h) == modele_min(&m), "tas", l, "Tas_sommet");
+			break;
+		case 3: // enlever une case
+		case 4: // marquer une case morte
+			if(h->size == 0)
+				break;
+			{
+				size_t pos = (size_t)val % h->size;
+				if(h->morts == NULL || !h->morts[pos])
+					modele_enlever(&m, (intptr_t)h->heap[pos]);
+				if(op == 3)
+					Tas_enlever_valeur(pos, h);
+				else
+					Tas_marquer_mort(h, pos);
+			}
+			break;
+		case 5: // compacter, ou vider en gardant la capacite
+			if(val % 16 == 0){
+				size_t capacite = h->capacite;
+				Tas_vider(h);
+				VERIFIER(Tas_estVide(h) && h->capacite == capacite, "tas", l, "Tas_vider");
+				m.n = 0;
+			}
+			else
+				Tas_compacter(h);
+			break;
+		case 6: // concatener un autre tas, ou h lui-meme
+			if(val % 4 == 0 && 2*m.n <= FUZZ_MAX){
+				Tas_concatener(h, h);
+				for(size_t i = 0, n = m.n; i < n; i++)
+					m.v[m.n++] = m.v[i];
+			}
+			else if(m.n + 8 <= FUZZ_MAX){
+				Heap h2 = Tas_creer(0);
+				Tas_fixer_comparateur(h2, Tas_comparer_entiers);
+				for(intptr_t i = 0; i < val % 8; i++){
+					Tas_ajouter_valeur(h2, (void*)(val + i));
+					m.v[m.n++] = val + i;
+				}
+				Tas_concatener(h, h2);
+				h2 = Tas_detruire(h2);
+			}
+			break;
+		case 7: // copie par concatenation dans un nouveau tas
+			{
+				Heap copie = Tas_concatener(NULL, h);
+				VERIFIER(Tas_taille(copie) == m.n && Tas_nb_morts(copie) == 0, "tas", l, "Tas_concatener(NULL, h)");
+				verifier_tas(copie, &m, l);
+				copie = Tas_detruire(copie);
+			}
+			break;
+		case 8:
+			VERIFIER(Tas_supprimer_egaux(h, (void*)val) == modele_compter(&m, val), "tas", l, "Tas_supprimer_egaux");
+			while(modele_compter(&m, val) > 0)
+				modele_enlever(&m, val);
+			break;
+		case 9:
+			VERIFIER(Tas_compter_egaux(h, (void*)val) == modele_compter(&m, val), "tas", l, "Tas_compter_egaux");
+			VERIFIER((Tas_trouver(h, (void*)val) == TAS_ABSENT) == (modele_compter(&m, val) == 0), "tas", l, "Tas_trouver");
+			break;
+		default:
+			Tas_fixer_minmax(h, !h->minmax);
+			break;
+		}
+		verifier_tas(h, &m, l);
+	}
+	// Les ajouts doublent la capacite : au plus un realloc par puissance de deux
+	if(FUZZ_BUDGETS)
+		VERIFIER(reallocations_ajouts <= hauteur(h->capacite), "tas", l, "budget de reallocations des ajouts");
+	h = Tas_detruire(h);
+}
+
+
+/* ---------- Liste ---------- */
+
+static int* nouvel_entier(unsigned x){
+	int* val = malloc(sizeof(int));
+	if(val == NULL)
+		abort();
+	*val = (int)x;
+	return val;
+}
+
+static int comparer_entiers(const void* a, const void* b){
+	int x = *(const int*)a, y = *(const int*)b;
+	return (x > y) - (x < y);
+}
+
+// Le modele de la liste : les valeurs dans l'ordre
+struct modele_liste{
+	int v[FUZZ_MAX + 8];
+	size_t n;
+};
+
+static void modele_inserer(struct modele_liste* m, size_t i, int val){
+	memmove(m->v + i + 1, m->v + i, (m->n - i) * sizeof(int));
+	m->v[i] = val;
+	m->n++;
+}
+
+static void modele_retirer(struct modele_liste* m, size_t i){
+	memmove(m->v + i, m->v + i + 1, (m->n - i - 1) * sizeof(int));
+	m->n--;
+}
+
+static void verifier_liste(struct LinkedList* list, const struct modele_liste* m, struct lecteur* l){
+	VERIFIER(ll_size(list) == m->n && ll_empty(list) == (m->n == 0), "liste", l, "nombre de valeurs");
+	ll_compact(list);
+	size_t i = 0;
+	for(struct Node* ite = list->first; ite != NULL; ite = ite->next, i++)
+		VERIFIER(i < m->n && *(int*)ite->value == m->v[i], "liste", l, "contenu");
+	VERIFIER(i == m->n, "liste", l, "longueur du chainage");
+}
+
+// Noeud vivant a la position i
+static struct Node* noeud(struct LinkedList* list, size_t i){
+	ll_compact(list);
+	struct Node* ite = list->first;
+	while(i-- > 0)
+		ite = ite->next;
+	return ite;
+}
+
+static void rejouer_liste(struct lecteur* l){
+	static struct modele_liste m;
+	struct LinkedList* list = ll_create();
+
+	ll_set_value_size(list, sizeof(int));
+	m.n = 0;
+	l->pos = 0;
+	while(l->pos < l->taille){
+		unsigned op = octet(l) % 12;
+		unsigned val = octet(l);
+		size_t n = m.n;
+		size_t i = n ? (size_t)octet(l) % n : 0;
+		size_t plus_court = (i < n - i) ? i : n - i;
+		int sans_morts = (ll_dead_count(list) == 0);
+
+		mesurer(INSTR_LISTE);
+		switch(op){
+		case 0:
+		case 1:
+			if(n >= FUZZ_MAX)
+				break;
+			if(op == 0){
+				ll_push_front(list, nouvel_entier(val));
+				modele_inserer(&m, 0, (int)val);
+			}
+			else{
+				ll_push_back(list, nouvel_entier(val));
+				modele_inserer(&m, n, (int)val);
+			}
+			if(FUZZ_BUDGETS && sans_morts){
+				VERIFIER(DEPUIS(INSTR_LISTE, pas_parcours) == 0, "liste", l, "budget de parcours d'un push");
+				VERIFIER(DEPUIS(INSTR_LISTE, allocations) <= 1, "liste", l, "budget d'allocations d'un push");
+			}
+			break;
+		case 2: // insertion de 1 a 3 copies
+			if(n == 0 || n + 3 > FUZZ_MAX)
+				break;
+			{
+				size_t k = 1 + val % 3;
+				ll_insert(list, i, nouvel_entier(val), k);
+				for(size_t j = 0; j < k; j++)
+					modele_inserer(&m, i, (int)val);
+				if(FUZZ_BUDGETS && sans_morts)
+					VERIFIER(DEPUIS(INSTR_LISTE, pas_parcours) <= plus_court, "liste", l, "budget de parcours de ll_insert");
+			}
+			break;
+		case 3: // insertion d'une suite de valeurs
+			if(n + 8 > FUZZ_MAX)
+				break;
+			{
+				void* valeurs[8];
+				size_t k = val % 8 + 1, pos = (val & 1) ? n : i;
+				for(size_t j = 0; j < k; j++){
+					valeurs[j] = nouvel_entier(val + j);
+					modele_inserer(&m, pos + j, (int)(val + j));
+				}
+				ll_insert_range(list, pos, valeurs, k);
+			}
+			break;
+		case 4:
+			if(n == 0)
+				break;
+			ll_remove_at(list, i);
+			modele_retirer(&m, i);
+			if(FUZZ_BUDGETS && sans_morts)
+				VERIFIER(DEPUIS(INSTR_LISTE, pas_parcours) <= i, "liste", l, "budget de parcours de ll_remove_at");
+			break;
+		case 5:
+			if(n == 0)
+				break;
+			{
+				// Sous le seuil, les noeuds tues sont sautes et non compactes
+				size_t morts = ll_dead_count(list);
+				int sous_seuil = morts < list->compaction_threshold * list->length;
+				VERIFIER(*(int*)ll_get(list, i) == m.v[i], "liste", l, "ll_get");
+				VERIFIER(!sous_seuil || ll_dead_count(list) == morts, "liste", l, "ll_get sans compactage");
+			}
+			if(FUZZ_BUDGETS && sans_morts)
+				VERIFIER(DEPUIS(INSTR_LISTE, pas_parcours) <= i, "liste", l, "budget de parcours de ll_get");
+			break;
+		case 6: // le pop rend la valeur a l'appelant
+			if(n == 0)
+				break;
+			{
+				int* v = (val & 1) ? ll_pop_back(list) : ll_pop_front(list);
+				VERIFIER(*v == m.v[(val & 1) ? n-1 : 0], "liste", l, "ll_pop");
+				modele_retirer(&m, (val & 1) ? n-1 : 0);
+				free(v);
+			}
+			break;
+		case 7:
+			{
+				int cherche = (int)val;
+				size_t premier = 0;	// une comparaison par element vivant jusqu'a la valeur
+				while(premier < n && m.v[premier] != cherche)
+					premier++;
+				int present = premier < n;
+				VERIFIER(ll_contains(list, &cherche) == present, "liste", l, "ll_contains");
+				if(FUZZ_BUDGETS){
+					VERIFIER(DEPUIS(INSTR_LISTE, pas_parcours) <= list->length, "liste", l, "budget de parcours de ll_contains");
+					VERIFIER(DEPUIS(INSTR_LISTE, comparaisons) == (present ? premier+1 : n), "liste", l, "comparaisons de ll_contains");
+				}
+			}
+			break;
+		case 8:
+			if(n == 0)
+				break;
+			ll_kill(list, noeud(list, i));
+			modele_retirer(&m, i);
+			break;
+		case 9: // compacter, ou vider en gardant les noeuds
+			if(val % 16 == 0){
+				ll_reset(list);
+				m.n = 0;
+			}
+			ll_compact(list);
+			VERIFIER(ll_dead_count(list) == 0, "liste", l, "ll_compact");
+			break;
+		case 10:
+			{
+				struct LinkedList* copie = ll_clone(list);
+				verifier_liste(copie, &m, l);
+				ll_destroy(copie);
+			}
+			break;
+		default:
+			ll_sort(list, comparer_entiers);
+			for(size_t j = 1; j < n; j++){
+				int x = m.v[j];
+				size_t k = j;
+				for(; k > 0 && m.v[k-1] > x; k--)
+					m.v[k] = m.v[k-1];
+				m.v[k] = x;
+			}
+			break;
+		}
+		verifier_liste(list, &m, l);
+	}
+	ll_destroy(list);
+}
+
+
+int LLVMFuzzerTestOneInput(const uint8_t* donnees, size_t taille);
+
+int LLVMFuzzerTestOneInput(const uint8_t* donnees, size_t taille){
+	struct lecteur l = { donnees, taille, 0 };
+	rejouer_tas(&l);
+	rejouer_liste(&l);
+	return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+
+// Rejoue un fichier du corpus, ou l'entree standard pour "-"
+static void rejouer_fichier(const char* nom){
+	FILE* f = (strcmp(nom, "-") == 0) ? stdin : fopen(nom, "rb");
+	uint8_t* donnees = NULL;
+	size_t taille = 0, capacite = 0, lu;
+
+	if(f == NULL){
+		perror(nom);
+		exit(1);
+	}
+	do{
+		if(taille == capacite){
+			capacite = capacite ? 2*capacite : 4096;
+			if((donnees = realloc(donnees, capacite)) == NULL)
+				abort();
+		}
+		lu = fread(donnees + taille, 1, capacite - taille, f);
+		taille += lu;
+	}while(lu > 0);
+	if(f != stdin)
+		fclose(f);
+	LLVMFuzzerTestOneInput(donnees, taille);
+	free(donnees);
+}
+
+int main(int argc, char** argv){
+	static uint8_t donnees[FUZZ_TAILLE];
+	uint64_t graine = 88172645463325252ULL;
+
+	if(argc > 1){
+		for(int i = 1; i < argc; i++)
+			rejouer_fichier(argv[i]);
+		printf("%d entrees rejouees\n", argc-1);
+		return 0;
+	}
+	for(int s = 0; s < FUZZ_NB_SUITES; s++){
+		size_t taille = 1 + s % sizeof(donnees);
+		for(size_t i = 0; i < taille; i++){
+			graine ^= graine << 13;
+			graine ^= graine >> 7;
+			graine ^= graine << 17;
+			donnees[i] = (uint8_t)graine;
+		}
+		LLVMFuzzerTestOneInput(donnees, taille);
+	}
+	printf("%d suites aleatoires rejouees%s\n", FUZZ_NB_SUITES,
+		FUZZ_BUDGETS ? ", budgets de complexite verifies" : "");
+	return 0;
+}
+
+#endif
@@ -0,0 +1,581 @@
+/**
+ * \file rejouer.c
+ * \author Zevio.S et Benharchache.S
+ * \brief Rejoue une trace (Trace.h) sur plusieurs moteurs pour les comparer
+ * \date 18 decembre 2014
+ *
+ * Usage : rejouer fichier.trace [moteur...]   (tous les moteurs par defaut)
+ *
+ * Les moteurs de tas rejouent les operations du tas de la trace, ceux de liste
+ * les operations de la liste : deux moteurs d'un meme genre recoivent
+ * exactement la meme suite d'operations. Les valeurs du tas sont celles de la
+ * trace, comparees comme des entiers (Tas_comparer_entiers). Les positions
+ * sont ramenees a la taille du conteneur rejoue, et une operation impossible
+ * (extraction d'un conteneur vide...) est comptee dans ignorees. Un conteneur
+ * qui apparait sans avoir ete cree pendant la trace est cree vide.
+ *
+ * Chaque moteur est rejoue dans un processus fils : la memoire maximale de
+ * l'un ne compte pas dans celle du suivant. Une ligne CSV par moteur :
+ * moteur,operations,ignorees,secondes,ops_par_s,p50_ns,p99_ns,p999_ns,rss_max_ko,rss_conteneurs_ko
+ *
+ * rss_conteneurs_ko est la croissance de la memoire maximale pendant le
+ * rejeu, hors trace chargee et tableau des latences.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "Heap.h"
+#include "TasGenerique.h"
+#include "Trace.h"
+#include "autres/LinkedList.h"
+#include "autres/PoolList.h"
+
+// Les resultats y sont accumules pour que le compilateur ne supprime pas les appels
+static volatile uintptr_t puits;
+
+static uint64_t horloge(void){
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec*1000000000u + (uint64_t)t.tv_nsec;
+}
+
+/*
+ * Un moteur : les fonctions qui rejouent les operations d'un genre de conteneur.
+ * executer retourne 0 si l'operation est impossible sur le conteneur rejoue.
+ */
+struct moteur{
+	const char* nom;
+	int liste;	// 1 : operations TRACE_LISTE_*, 0 : operations TRACE_TAS_*
+	void* (*creer)(void);
+	void (*detruire)(void* c);
+	void* (*copier)(void* c);
+	int (*executer)(void* c, enum trace_operation op, uint64_t arg, void* autre);
+};
+
+
+/* ---- Tas ---- */
+
+static void* tas_creer(void){
+	Heap h = Tas_creer(0);
+	Tas_fixer_comparateur(h, Tas_comparer_entiers);
+	return h;
+}
+
+static void* tas_minmax_creer(void){
+	Heap h = tas_creer();
+	Tas_fixer_minmax(h, 1);
+	return h;
+}
+
+static void tas_detruire(void* c){
+	Tas_detruire(c);
+}
+
+static void* tas_copier(void* c){
+	return Tas_creerTasParCopie(c);
+}
+
+static int tas_executer(void* c, enum trace_operation op, uint64_t arg, void* autre){
+	Heap h = c;
+	switch(op){
+	case TRACE_TAS_AJOUTER:
+		Tas_ajouter_valeur(h, (void*)(uintptr_t)arg);
+		return 1;
+	case TRACE_TAS_EXTRAIRE:
+		if(Tas_estVide(h))
+			return 0;
+		puits += (uintptr_t)Tas_extraire(h);
+		return 1;
+	case TRACE_TAS_ENLEVER:
+		if(Tas_taille(h) == 0)
+			return 0;
+		Tas_enlever_valeur(arg % Tas_taille(h), h);
+		return 1;
+	case TRACE_TAS_CONCATENER:
+		Tas_concatener(h, autre);
+		return 1;
+	case TRACE_TAS_VIDER:
+		Tas_vider(h);
+		return 1;
+	case TRACE_TAS_BORNER:
+		Tas_fixer_borne(h, (size_t)arg);
+		return 1;
+	case TRACE_TAS_PROPOSER:
+		Tas_proposer(h, (void*)(uintptr_t)arg, NULL);
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+DEFINE_HEAP(TasRejeu, intptr_t, TAS_CMP_NATUREL)
+
+// Le tas type n'a pas de mode borne : le moteur garde la borne a cote
+struct generique{
+	TasRejeu tas;	// en premier : un struct generique* est un TasRejeu*
+	size_t borne;
+};
+
+static void* generique_creer(void){
+	struct generique* g = malloc(sizeof(struct generique));
+	if(g == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir de la structure");
+		exit(1);
+	}
+	TasRejeu_initialiser(&g->tas);
+	g->borne = 0;
+	return g;
+}
+
+static void generique_detruire(void* c){
+	TasRejeu_finaliser(c);
+	free(c);
+}
+
+static void* generique_copier(void* c){
+	struct generique* src = c;
+	struct generique* g = generique_creer();
+	TasRejeu_tasser(&g->tas, src->tas.cases, src->tas.taille);
+	g->borne = src->borne;
+	return g;
+}
+
+// Comme Tas_proposer : une fois plein, la valeur remplace le sommet si elle sort apres lui
+static void generique_proposer(struct generique* g, intptr_t v){
+	if(g->borne == 0 || g->tas.taille < g->borne)
+		TasRejeu_ajouter(&g->tas, v);
+	else if(TAS_CMP_NATUREL(v, g->tas.cases[0]) > 0)
+		TasRejeu_descendre(&g->tas, 0, v);
+}
+
+static int generique_executer(void* c, enum trace_operation op, uint64_t arg, void* autre){
+	struct generique* g = c;
+	TasRejeu* h = &g->tas;
+	switch(op){
+	case TRACE_TAS_AJOUTER:
+		TasRejeu_ajouter(h, (intptr_t)arg);
+		return 1;
+	case TRACE_TAS_EXTRAIRE:
+		if(TasRejeu_estVide(h))
+			return 0;
+		puits += (uintptr_t)TasRejeu_extraire(h);
+		return 1;
+	case TRACE_TAS_ENLEVER:{
+		if(TasRejeu_estVide(h))
+			return 0;
+		size_t i = arg % h->taille;
+		intptr_t dernier = h->cases[--h->taille];
+		if(i == h->taille)
+			return 1;
+		if(i > 0 && TAS_CMP_NATUREL(dernier, h->cases[(i-1)/2]) < 0)
+			TasRejeu_remonter(h, i, dernier);
+		else
+			TasRejeu_descendre(h, i, dernier);
+		return 1;
+	}
+	case TRACE_TAS_CONCATENER:{
+		TasRejeu* h2 = autre;
+		if(g->borne > 0){
+			// Comme Tas_concatener : chaque valeur de h2 est proposee, h dans lui-meme ne change rien
+			for(size_t i = 0; h2 != h && i < h2->taille; i++)
+				generique_proposer(g, h2->cases[i]);
+		}
+		else if(h2 == h){
+			// tasser lit les valeurs apres avoir agrandi le tableau
+			TasRejeu* copie = generique_copier(h2);
+			TasRejeu_tasser(h, copie->cases, copie->taille);
+			generique_detruire(copie);
+		}
+		else
+			TasRejeu_tasser(h, h2->cases, h2->taille);
+		return 1;
+	}
+	case TRACE_TAS_VIDER:
+		h->taille = 0;
+		return 1;
+	case TRACE_TAS_BORNER:
+		g->borne = (size_t)arg;
+		while(g->borne > 0 && h->taille > g->borne)
+			puits += (uintptr_t)TasRejeu_extraire(h);
+		return 1;
+	case TRACE_TAS_PROPOSER:
+		generique_proposer(g, (intptr_t)arg);
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+
+/* ---- Listes ---- */
+
+// Chaque element a sa valeur allouee, comme dans un programme qui utilise la liste
+static void* valeur(uint64_t x){
+	uint64_t* v = malloc(sizeof(uint64_t));
+	if(v == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir de la valeur");
+		exit(1);
+	}
+	*v = x;
+	return v;
+}
+
+static void* liste_creer(void){
+	return ll_create();
+}
+
+static void liste_detruire(void* c){
+	ll_destroy(c);
+}
+
+static void* liste_copier(void* c){
+	return ll_clone(c);
+}
+
+static int liste_executer(void* c, enum trace_operation op, uint64_t arg, void* autre){
+	struct LinkedList* l = c;
+	size_t n = ll_size(l);
+	(void)autre;
+	switch(op){
+	case TRACE_LISTE_INSERER:
+		if(arg < n || n == 0)
+			ll_insert(l, (n == 0) ? 0 : arg, valeur(arg), 1);
+		else
+			ll_push_back(l, valeur(arg));
+		return 1;
+	case TRACE_LISTE_AJOUTER_FIN:
+		ll_push_back(l, valeur(arg));
+		return 1;
+	case TRACE_LISTE_ACCEDER:
+		if(n == 0)
+			return 0;
+		puits += (uintptr_t)ll_get(l, arg % n);
+		return 1;
+	case TRACE_LISTE_RETIRER:
+		if(n == 0)
+			return 0;
+		ll_remove_at(l, arg % n);
+		return 1;
+	case TRACE_LISTE_RETIRER_TETE:
+		if(n == 0)
+			return 0;
+		free(ll_pop_front(l));
+		return 1;
+	case TRACE_LISTE_RETIRER_FIN:
+		if(n == 0)
+			return 0;
+		free(ll_pop_back(l));
+		return 1;
+	case TRACE_LISTE_VIDER:
+		ll_reset(l);
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+static void* pool_creer(void){
+	return pl_create();
+}
+
+static void pool_detruire(void* c){
+	pl_destroy(c);
+}
+
+static void* copier_valeur(const void* v){
+	return valeur(*(const uint64_t*)v);
+}
+
+static void* pool_copier(void* c){
+	return pl_clone(c, copier_valeur);
+}
+
+// Case de l'element a la position i (i < taille)
+static uint32_t pool_case(struct PoolList* l, size_t i){
+	uint32_t ite = pl_first(l);
+	while(i-- > 0)
+		ite = pl_next(l, ite);
+	return ite;
+}
+
+static int pool_executer(void* c, enum trace_operation op, uint64_t arg, void* autre){
+	struct PoolList* l = c;
+	size_t n = pl_size(l);
+	(void)autre;
+	switch(op){
+	case TRACE_LISTE_INSERER:
+		if(arg == 0 || n == 0)
+			pl_push_front(l, valeur(arg));
+		else if(arg < n)
+			pl_insert_after(l, pool_case(l, arg-1), valeur(arg));
+		else
+			pl_push_back(l, valeur(arg));
+		return 1;
+	case TRACE_LISTE_AJOUTER_FIN:
+		pl_push_back(l, valeur(arg));
+		return 1;
+	case TRACE_LISTE_ACCEDER:
+		if(n == 0)
+			return 0;
+		puits += (uintptr_t)pl_get(l, arg % n);
+		return 1;
+	case TRACE_LISTE_RETIRER:
+		if(n == 0)
+			return 0;
+		pl_remove(l, pool_case(l, arg % n));
+		return 1;
+	case TRACE_LISTE_RETIRER_TETE:
+		if(n == 0)
+			return 0;
+		pl_remove(l, pl_first(l));
+		return 1;
+	case TRACE_LISTE_RETIRER_FIN:
+		if(n == 0)
+			return 0;
+		pl_remove(l, pl_last(l));
+		return 1;
+	case TRACE_LISTE_VIDER:
+		// Les cases retirees restent dans la liste pour les insertions suivantes
+		while(pl_size(l) > 0)
+			pl_remove(l, pl_first(l));
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+static const struct moteur moteurs[] = {
+	{ "tas", 0, tas_creer, tas_detruire, tas_copier, tas_executer },
+	{ "tas_minmax", 0, tas_minmax_creer, tas_detruire, tas_copier, tas_executer },
+	{ "tas_generique", 0, generique_creer, generique_detruire, generique_copier, generique_executer },
+	{ "liste", 1, liste_creer, liste_detruire, liste_copier, liste_executer },
+	{ "liste_pool", 1, pool_creer, pool_detruire, pool_copier, pool_executer },
+};
+#define NB_MOTEURS (sizeof(moteurs)/sizeof(moteurs[0]))
+
+
+/* ---- Conteneurs vivants, par adresse d'origine ---- */
+
+struct entree{
+	uint64_t cle;	// 0 : case vide
+	void* c;	// NULL dans une case non vide : conteneur detruit
+};
+
+struct table{
+	struct entree* entrees;
+	size_t capacite;	// puissance de deux
+	size_t occupees;	// cases non vides, detruits compris
+};
+
+static struct entree* table_case(struct table* t, uint64_t cle){
+	size_t i = (size_t)((cle >> 4) * 0x9E3779B97F4A7C15ULL) & (t->capacite-1);
+	while(t->entrees[i].cle != 0 && t->entrees[i].cle != cle)
+		i = (i+1) & (t->capacite-1);
+	return &t->entrees[i];
+}
+
+// Reconstruit la table sans les detruits, au moins deux fois plus grande que les vivants
+static void table_agrandir(struct table* t){
+	struct table nouvelle = { NULL, 64, 0 };
+	size_t vivants = 0;
+	for(size_t i = 0; i < t->capacite; i++)
+		vivants += t->entrees[i].c != NULL;
+	while(nouvelle.capacite < 4*(vivants+1))
+		nouvelle.capacite *= 2;
+	if((nouvelle.entrees = calloc(nouvelle.capacite, sizeof(struct entree))) == NULL){
+		fprintf(stderr, "errueut lors de l'allocation de memoir de la table");
+		exit(1);
+	}
+	for(size_t i = 0; i < t->capacite; i++){
+		if(t->entrees[i].c != NULL){
+			*table_case(&nouvelle, t->entrees[i].cle) = t->entrees[i];
+			nouvelle.occupees++;
+		}
+	}
+	free(t->entrees);
+	*t = nouvelle;
+}
+
+// Remplace le conteneur d'adresse cle (l'ancien est detruit)
+static void table_placer(struct table* t, const struct moteur* m, uint64_t cle, void* c){
+	if(2*(t->occupees+1) > t->capacite)
+		table_agrandir(t);
+	struct entree* e = table_case(t, cle);
+	if(e->cle == 0){
+		e->cle = cle;
+		t->occupees++;
+	}
+	else if(e->c != NULL)
+		m->detruire(e->c);
+	e->c = c;
+}
+
+// Conteneur d'adresse cle, cree vide s'il n'existe pas
+static void* table_conteneur(struct table* t, const struct moteur* m, uint64_t cle){
+	if(t->capacite > 0){
+		struct entree* e = table_case(t, cle);
+		if(e->c != NULL)
+			return e->c;
+	}
+	void* c = m->creer();
+	table_placer(t, m, cle, c);
+	return c;
+}
+
+static void table_vider(struct table* t, const struct moteur* m){
+	for(size_t i = 0; i < t->capacite; i++)
+		if(t->entrees[i].c != NULL)
+			m->detruire(t->entrees[i].c);
+	free(t->entrees);
+}
+
+
+/* ---- Rejeu ---- */
+
+static int comparer_durees(const void* a, const void* b){
+	uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+	return (x > y) - (x < y);
+}
+
+static long rss_max_ko(void){
+	struct rusage r;
+	getrusage(RUSAGE_SELF, &r);
+	return r.ru_maxrss;
+}
+
+static void rejouer(const struct moteur* m, const struct trace_evenement* e, size_t nb){
+	struct table t = { NULL, 0, 0 };
+	size_t operations = 0, ignorees = 0;
+	uint64_t* durees;
+
+	if((durees = malloc((nb ? nb : 1)*sizeof(uint64_t))) == NULL){
+		fprintf(stderr, "pas assez de memoire pour %zu durees\n", nb);
+		exit(1);
+	}
+	memset(durees, 0, (nb ? nb : 1)*sizeof(uint64_t));
+	long rss_base = rss_max_ko();
+
+	uint64_t debut = horloge();
+	for(size_t i = 0; i < nb; i++){
+		enum trace_operation op = TRACE_OPERATION(&e[i]);
+		if(op >= TRACE_NB_OPERATIONS || (op >= TRACE_LISTE_CREER) != m->liste)
+			continue;
+		int fait = 1;
+		uint64_t t0 = horloge();
+		switch(op){
+		case TRACE_TAS_CREER:
+		case TRACE_LISTE_CREER:
+			table_placer(&t, m, e[i].objet, m->creer());
+			break;
+		case TRACE_TAS_DETRUIRE:
+		case TRACE_LISTE_DETRUIRE:{
+			struct entree* c = t.capacite ? table_case(&t, e[i].objet) : NULL;
+			if(c != NULL && c->c != NULL){
+				m->detruire(c->c);
+				c->c = NULL;
+			}
+			else
+				fait = 0;
+			break;
+		}
+		case TRACE_TAS_COPIER:
+		case TRACE_LISTE_CLONER:
+			// Tas_creerTasParCopie(NULL) donne un tas vide
+			table_placer(&t, m, e[i].objet, e[i].arg ? m->copier(table_conteneur(&t, m, e[i].arg)) : m->creer());
+			break;
+		case TRACE_TAS_CONCATENER:{
+			void* h2 = table_conteneur(&t, m, e[i].arg);
+			fait = m->executer(table_conteneur(&t, m, e[i].objet), op, e[i].arg, h2);
+			break;
+		}
+		default:
+			fait = m->executer(table_conteneur(&t, m, e[i].objet), op, e[i].arg, NULL);
+			break;
+		}
+		if(fait)
+			durees[operations++] = horloge() - t0;
+		else
+			ignorees++;
+	}
+	double secondes = (horloge() - debut)*1e-9;
+	long rss = rss_max_ko();
+
+	qsort(durees, operations, sizeof(uint64_t), comparer_durees);
+	uint64_t p50 = operations ? durees[(operations-1)*50/100] : 0;
+	uint64_t p99 = operations ? durees[(operations-1)*99/100] : 0;
+	uint64_t p999 = operations ? durees[(operations-1)*999/1000] : 0;
+	printf("%s,%zu,%zu,%.6f,%.0f,%llu,%llu,%llu,%ld,%ld\n", m->nom, operations, ignorees, secondes,
+		secondes > 0 ? operations/secondes : 0.0, (unsigned long long)p50, (unsigned long long)p99,
+		(unsigned long long)p999, rss, rss - rss_base);
+	fflush(stdout);
+
+	table_vider(&t, m);
+	free(durees);
+}
+
+int main(int argc, char** argv){
+	const struct moteur* choisis[NB_MOTEURS];
+	size_t nb_choisis = 0, nb;
+	struct trace_evenement* e;
+
+	if(argc < 2){
+		fprintf(stderr, "usage : %s fichier.trace [moteur...]\nmoteurs :", argv[0]);
+		for(size_t j = 0; j < NB_MOTEURS; j++)
+			fprintf(stderr, " %s", moteurs[j].nom);
+		fprintf(stderr, "\n");
+		return 2;
+	}
+	for(int i = 2; i < argc; i++){
+		size_t j = 0;
+		while(j < NB_MOTEURS && strcmp(argv[i], moteurs[j].nom) != 0)
+			j++;
+		if(j == NB_MOTEURS || nb_choisis == NB_MOTEURS){
+			fprintf(stderr, "moteur inconnu : %s\n", argv[i]);
+			return 2;
+		}
+		choisis[nb_choisis++] = &moteurs[j];
+	}
+	if(nb_choisis == 0){
+		for(size_t j = 0; j < NB_MOTEURS; j++)
+			choisis[nb_choisis++] = &moteurs[j];
+	}
+
+	if((e = Trace_lire(argv[1], &nb)) == NULL){
+		fprintf(stderr, "%s n'est pas une trace lisible\n", argv[1]);
+		return 1;
+	}
+
+	printf("moteur,operations,ignorees,secondes,ops_par_s,p50_ns,p99_ns,p999_ns,rss_max_ko,rss_conteneurs_ko\n");
+	fflush(stdout);
+	int code = 0;
+	for(size_t j = 0; j < nb_choisis; j++){
+		pid_t fils = fork();
+		if(fils < 0){
+			perror("fork");
+			return 1;
+		}
+		if(fils == 0){
+			rejouer(choisis[j], e, nb);
+			free(e);
+			_exit(0);
+		}
+		int statut;
+		waitpid(fils, &statut, 0);
+		if(!WIFEXITED(statut) || WEXITSTATUS(statut) != 0){
+			fprintf(stderr, "le rejeu sur %s a echoue\n", choisis[j]->nom);
+			code = 1;
+		}
+	}
+
+	free(e);
+	return code;
+}
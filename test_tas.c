@@ -5,10 +5,101 @@
  * \date 18 decembre 2014
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/wait.h>
 
 #include "Heap.h"
+#include "TasExterne.h"
+#include "TasPartage.h"
+#include "TasGenerique.h"
+#include "TasPipeline.h"
+#include "Conversion.h"
+#include "Instrumentation.h"
+#include "Recyclage.h"
+#include "Trace.h"
+
+// Comparateur de valeurs qui pointent sur un int
+static int Tas_comparer_pointes(const void* a, const void* b){
+	int x = *(const int*)a, y = *(const int*)b;
+	return (x > y) - (x < y);
+}
+
+// Verifie qu'un tas persistant contient 0, 1, ..., n-1
+static int verifier_persistant(Heap h, size_t n){
+	if(h == NULL || Tas_taille(h) != n)
+		return 0;
+	for(size_t i = 0; i < n; i++)
+		if((intptr_t)h->heap[i] != (intptr_t)i)
+			return 0;
+	return 1;
+}
+
+// Tas d'int, sans void* ni pointeur de fonction
+DEFINE_HEAP(TasEntiers, int, TAS_CMP_NATUREL)
+
+// Travail d'un fil sur la file partagee : 1000 ajouts puis 1000 extractions
+struct fil_partage{
+	TasPartage t;
+	intptr_t premier;
+	intptr_t somme;
+	size_t extraites;
+};
+
+static void* fil_partage(void* arg){
+	struct fil_partage* f = arg;
+	void* v;
+	for(intptr_t i = 0; i < 1000; i++)
+		TasPartage_ajouter(f->t, (void*)(f->premier + i));
+	for(int i = 0; i < 1000 && TasPartage_extraire(f->t, &v); i++){
+		f->somme += (intptr_t)v;
+		f->extraites++;
+	}
+	return NULL;
+}
+
+// Producteur de l'etage de pipeline : 10000 valeurs melangees, par lots de 100
+static void* producteur_pipeline(void* arg){
+	void* lot[100];
+	for(intptr_t i = 0; i < 10000; i += 100){
+		for(intptr_t j = 0; j < 100; j++)
+			lot[j] = (void*)((i+j)*7919 % 10000);
+		TasPipeline_envoyer_lot(arg, lot, 100);
+	}
+	TasPipeline_fermer(arg);
+	return NULL;
+}
+
+// Enregistre 10000 ajouts sur le tas d'adresse arg (plus que deux tampons)
+static void* fil_trace(void* arg){
+	for(uint64_t i = 0; i < 10000; i++)
+		Trace_evenement(TRACE_TAS_AJOUTER, arg, i);
+	return NULL;
+}
+
+// Formateur large : 15 octets pour 0, TAS_FORMAT_MAX pour les autres valeurs
+static size_t formater_large(char* tampon, const void* val){
+	size_t k = val == NULL ? 15 : TAS_FORMAT_MAX;
+	for(size_t i = 0; i < k; i++)
+		tampon[i] = 'x';
+	return k;
+}
+
+// Predicat : la valeur est paire
+static int est_pair(const void* val, void* contexte){
+	(void)contexte;
+	return ((intptr_t)val % 2) == 0;
+}
+
+// Action : ajoute la valeur a la somme pointee par contexte
+static void sommer(void* val, void* contexte){
+	*(intptr_t*)contexte += (intptr_t)val;
+}
 
 int main(){
 	Heap h=NULL;
@@ -45,14 +136,19 @@ int main(){
 
 	printf("%s\n", "\n=======  ajouter variable  ========");
 	int j=666;
-	int*val=(int*)malloc(sizeof(int));
-	val=(void *)(intptr_t)j;
+	void* val=(void *)(intptr_t)j;
 	Tas_ajouter_valeur(h2, val);
 	Tas_afficher(h2);
 
 	printf("%s\n", "\n=======  creer tas par copie  ========");
 	Heap h3 = Tas_creerTasParCopie(h2);
 	Tas_afficher(h3);
+	Heap hnul = Tas_creerTasParCopie(NULL);
+	Tas_fixer_comparateur(hnul, Tas_comparer_entiers);
+	for(intptr_t i = 20; i > 0; i--)
+		Tas_ajouter_valeur(hnul, (void*)i);
+	printf("copie de NULL : taille %zu, sommet %d\n", Tas_taille(hnul), (int)(intptr_t)Tas_sommet(hnul));
+	hnul = Tas_detruire(hnul);
 
 
 	printf("%s\n", "\n=======  enlever element du tas  ========");
@@ -60,14 +156,457 @@ int main(){
 	h3 = Tas_enlever_valeur(3, h3);
 	h3 = Tas_enlever_valeur(3, h3);
 	h3 = Tas_enlever_valeur(3, h3);
-	h3 = Tas_enlever_valeur(3, h3);
 	Tas_afficher(h3);
 
 
+	printf("%s\n", "\n=======  tas persistant  ========");
+	char chemin[] = "/tmp/biblisd_tasXXXXXX";
+	int fd = mkstemp(chemin);
+	close(fd);
+	Heap hp = Tas_ouvrirPersistant(chemin, 0);
+	for(intptr_t i = 0; i < 1000; i++)
+		Tas_ajouter_valeur(hp, (void*)i);
+	Tas_synchroniser(hp);
+	hp = Tas_detruire(hp);
+	hp = Tas_ouvrirPersistant(chemin, 0);
+	printf("reouverture : %s\n", verifier_persistant(hp, 1000) ? "ok" : "ECHEC");
+	hp = Tas_detruire(hp);
+
+	// Le fils ajoute des valeurs puis meurt sans fermer le tas
+	pid_t pid = fork();
+	if(pid == 0){
+		hp = Tas_ouvrirPersistant(chemin, 0);
+		for(intptr_t i = 1000; i < 5000; i++)
+			Tas_ajouter_valeur(hp, (void*)i);
+		abort();
+	}
+	waitpid(pid, NULL, 0);
+	hp = Tas_ouvrirPersistant(chemin, 0);
+	printf("apres crash : %s\n", verifier_persistant(hp, 5000) ? "ok" : "ECHEC");
+	hp = Tas_detruire(hp);
+	unlink(chemin);
+
+
+	printf("%s\n", "\n=======  ecrire / lire  ========");
+	FILE* fichier = tmpfile();
+	Tas_ecrire(h2, fileno(fichier));
+	lseek(fileno(fichier), 0, SEEK_SET);
+	Heap h4 = Tas_lire(fileno(fichier), Tas_comparer_entiers);
+	fclose(fichier);
+	while(!Tas_estVide(h4))
+		printf("%d ", (int)(intptr_t)Tas_extraire(h4));
+	printf("\n");
+	h4 = Tas_detruire(h4);
+	// Un en-tete dont le tableau de 2*nb cases deborderait size_t est refuse
+	fichier = tmpfile();
+	Tas_ecrire(h2, fileno(fichier));
+	uint64_t nb_enorme = SIZE_MAX/sizeof(void*);
+	pwrite(fileno(fichier), &nb_enorme, sizeof(nb_enorme), 16);
+	lseek(fileno(fichier), 0, SEEK_SET);
+	printf("en-tete enorme : %s\n", Tas_lire(fileno(fichier), Tas_comparer_entiers) == NULL ? "refuse" : "ECHEC");
+	fclose(fichier);
+
+
+	printf("%s\n", "\n=======  formater  ========");
+	char texte[12];
+	size_t besoin = Tas_formater(h2, texte, sizeof(texte), Tas_formater_entier);
+	printf("%zu octets, tronque : \"%s\"\n", besoin, texte);
+	// 16 + 1008*(TAS_FORMAT_MAX+1) = 65536 : la derniere valeur remplit le tampon jusqu'au bout
+	Heap hl = Tas_creer(0);
+	for(intptr_t i = 0; i < 1009; i++)
+		Tas_ajouter_valeur(hl, (void*)i);
+	fichier = tmpfile();
+	Tas_ecrire_texte(hl, fileno(fichier), formater_large);
+	off_t fin = lseek(fileno(fichier), 0, SEEK_END);
+	char dernier = 0;
+	pread(fileno(fichier), &dernier, 1, fin-1);
+	printf("tampon plein : %lld octets, %s\n", (long long)fin, dernier == '\n' ? "fin de ligne ok" : "ECHEC");
+	fclose(fichier);
+	hl = Tas_detruire(hl);
+
+
+	printf("%s\n", "\n=======  liste -> tas -> liste  ========");
+	struct LinkedList* liste = ll_create();
+	for(int i = 0; i < 10; i++){
+		int* v = malloc(sizeof(int));
+		*v = (i * 7) % 10;
+		ll_push_back(liste, v);
+	}
+	Heap h5 = Tas_depuisListe(liste, Tas_comparer_pointes);
+	printf("liste videe : %zu elements, tas : %zu elements, sommet %d\n",
+		ll_size(liste), Tas_taille(h5), *(int*)Tas_sommet(h5));
+	ll_destroy(liste);
+	liste = Tas_versListe(h5);
+	h5 = Tas_detruire(h5); // les valeurs appartiennent maintenant a la liste
+	ll_sort(liste, Tas_comparer_pointes);
+	fflush(stdout);
+	ll_dump(liste, STDOUT_FILENO, ll_format_int);
+	ll_destroy(liste);
+
+
+	printf("%s\n", "\n=======  instrumentation  ========");
+	struct instr_compteurs compteurs;
+	Instr_instantane(INSTR_TAS, &compteurs);
+	printf("ajouts %llu, reallocations %llu, comparaisons %llu\n",
+		(unsigned long long)compteurs.operations[INSTR_AJOUT],
+		(unsigned long long)compteurs.reallocations,
+		(unsigned long long)compteurs.comparaisons);
+	Instr_reinitialiser();
+
+
+	printf("%s\n", "\n=======  suppression paresseuse  ========");
+	Heap hm = Tas_creer(0);
+	Tas_fixer_comparateur(hm, Tas_comparer_entiers);
+	Tas_fixer_seuil(hm, 0.5);
+	for(intptr_t i = 0; i < 10; i++)
+		Tas_ajouter_valeur(hm, (void*)i);
+	for(size_t i = 0; i < 4; i++)
+		Tas_marquer_mort(hm, i);
+	printf("taille %zu, mortes %zu : ", Tas_taille(hm), Tas_nb_morts(hm));
+	Tas_afficher(hm);
+	printf("extrait %d, ", (int)(intptr_t)Tas_extraire(hm));
+	printf("mortes %zu\n", Tas_nb_morts(hm));
+	for(size_t i = 0; i < 3; i++)
+		Tas_marquer_mort(hm, i);
+	printf("apres compactage : taille %zu, mortes %zu : ", Tas_taille(hm), Tas_nb_morts(hm));
+	Tas_afficher(hm);
+	hm = Tas_detruire(hm);
+
+	printf("%s\n", "\n=======  tas borne (top 10)  ========");
+	void* flux[1000];
+	for(size_t i = 0; i < 1000; i++)
+		flux[i] = (void*)(intptr_t)(i*7919 % 1000); // 0..999 dans le desordre
+	Heap hb = Tas_creerBorne(10, Tas_comparer_entiers);
+	size_t sorties = 0;
+	for(size_t i = 0; i < 1000; i++){
+		void* sortie;
+		sorties += Tas_proposer(hb, flux[i], &sortie);
+	}
+	printf("%zu sorties, capacite %zu : ", sorties, hb->capacite);
+	while(!Tas_estVide(hb))
+		printf("%d ", (int)(intptr_t)Tas_extraire(hb));
+	printf("\n");
+	hb = Tas_detruire(hb);
+	hb = Tas_selectionner(flux, 1000, 10, Tas_comparer_entiers, 4);
+	printf("4 fils : ");
+	while(!Tas_estVide(hb))
+		printf("%d ", (int)(intptr_t)Tas_extraire(hb));
+	printf("\n");
+	hb = Tas_detruire(hb);
+
+	printf("%s\n", "\n=======  tas min-max  ========");
+	Heap hmm = Tas_creer(0);
+	Tas_fixer_comparateur(hmm, Tas_comparer_entiers);
+	Tas_fixer_minmax(hmm, 1);
+	for(size_t i = 0; i < 1000; i++)
+		Tas_ajouter_valeur(hmm, flux[i]);
+	for(size_t i = 0; i < 100; i++)
+		Tas_enlever_valeur(i*7 % Tas_taille(hmm), hmm);
+	for(size_t i = 0; i < 3; i++){
+		printf("%d ", (int)(intptr_t)Tas_extraire_min(hmm));
+		printf("%d ", (int)(intptr_t)Tas_extraire_max(hmm));
+	}
+	// Le reste doit sortir dans l'ordre par les deux bouts
+	intptr_t bas = -1, haut = 1000;
+	int ordre = 1;
+	while(!Tas_estVide(hmm)){
+		intptr_t mini = (intptr_t)Tas_min(hmm), maxi = (intptr_t)Tas_max(hmm);
+		ordre = ordre && mini >= bas && maxi <= haut && mini <= maxi;
+		bas = (intptr_t)Tas_extraire_min(hmm);
+		if(!Tas_estVide(hmm))
+			haut = (intptr_t)Tas_extraire_max(hmm);
+	}
+	printf("... %s\n", ordre ? "ok" : "ECHEC");
+	hmm = Tas_detruire(hmm);
+
+	printf("%s\n", "\n=======  petit tas  ========");
+	Heap hpetit = Tas_creer(0);
+	for(intptr_t i = 0; i < TAS_PETIT; i++)
+		Tas_ajouter_valeur(hpetit, (void*)i);
+	printf("%d cases dans la structure : %s, ", TAS_PETIT, hpetit->heap == hpetit->petit ? "oui" : "non");
+	Tas_ajouter_valeur(hpetit, (void*)(intptr_t)TAS_PETIT);
+	printf("une de plus : %s\n", hpetit->heap == hpetit->petit ? "oui" : "non");
+	Tas_afficher(hpetit);
+	hpetit = Tas_detruire(hpetit);
+
+	printf("%s\n", "\n=======  tas sur la pile  ========");
+	struct heap_struct pile;
+	Tas_initialiser(&pile, 0);
+	Tas_fixer_comparateur(&pile, Tas_comparer_entiers);
+	for(intptr_t i = 20; i > 0; i--)
+		Tas_ajouter_valeur(&pile, (void*)i);
+	printf("sommet %d, taille %zu\n", (int)(intptr_t)Tas_sommet(&pile), Tas_taille(&pile));
+	Tas_finaliser(&pile);
+
+	printf("%s\n", "\n=======  tas externe  ========");
+	// 64 Kio de budget pour 100000 valeurs : la plupart passent par le disque
+	TasExterne te = TasExterne_creer(Tas_comparer_entiers, 65536);
+	size_t series_max = 0;
+	intptr_t precedent = -1;
+	int trie = 1;
+	for(intptr_t i = 0; i < 100000; i++){
+		TasExterne_ajouter(te, (void*)(i*7919 % 100000));
+		if(TasExterne_nb_series(te) > series_max)
+			series_max = TasExterne_nb_series(te);
+		if(i % 10 == 9){
+			// Les extractions melangees aux ajouts ne sont pas forcement croissantes
+			TasExterne_extraire(te);
+		}
+	}
+	printf("%llu valeurs, jusqu'a %zu series, ", (unsigned long long)TasExterne_taille(te), series_max);
+	while(!TasExterne_estVide(te)){
+		intptr_t v = (intptr_t)TasExterne_extraire(te);
+		trie = trie && v >= precedent;
+		precedent = v;
+	}
+	printf("%s\n", trie ? "trie" : "ECHEC");
+	te = TasExterne_detruire(te);
+	// 1 Kio de budget : 1563 vidages de 64 valeurs, fusionnes par niveaux de 16
+	te = TasExterne_creer(Tas_comparer_entiers, 1024);
+	for(intptr_t i = 0; i < 100000; i++)
+		TasExterne_ajouter(te, (void*)(i*7919 % 100000));
+	printf("petit budget : %.1f ecritures par valeur, ", (double)te->ecritures / 100000);
+	precedent = -1;
+	trie = 1;
+	while(!TasExterne_estVide(te)){
+		intptr_t v = (intptr_t)TasExterne_extraire(te);
+		trie = trie && v >= precedent;
+		precedent = v;
+	}
+	printf("%s\n", trie ? "trie" : "ECHEC");
+	te = TasExterne_detruire(te);
+
+	printf("%s\n", "\n=======  tas partage  ========");
+	TasPartage tp = TasPartage_creer(Tas_comparer_entiers, 2);
+	struct fil_partage fp[4];
+	pthread_t fils_partage[4];
+	intptr_t somme_partage = 0;
+	size_t extraites = 0;
+	for(int i = 0; i < 4; i++){
+		fp[i].t = tp;
+		fp[i].premier = i*1000;
+		fp[i].somme = 0;
+		fp[i].extraites = 0;
+		pthread_create(&fils_partage[i], NULL, fil_partage, &fp[i]);
+	}
+	for(int i = 0; i < 4; i++){
+		pthread_join(fils_partage[i], NULL);
+		somme_partage += fp[i].somme;
+		extraites += fp[i].extraites;
+	}
+	// Ce que les fils n'ont pas pu prendre est encore dans la file
+	void* reste_partage;
+	while(TasPartage_extraire(tp, &reste_partage)){
+		somme_partage += (intptr_t)reste_partage;
+		extraites++;
+	}
+	struct tas_partage_stats stats_partage;
+	TasPartage_statistiques(tp, &stats_partage);
+	printf("%zu valeurs extraites, somme %s, compteurs %s\n", extraites,
+		somme_partage == 3999*4000/2 ? "exacte" : "ECHEC",
+		stats_partage.ajouts == 4000 && stats_partage.extractions_locales + stats_partage.extractions_voisines
+			+ stats_partage.extractions_distantes == 4000 ? "coherents" : "ECHEC");
+	tp = TasPartage_detruire(tp);
+
+	printf("%s\n", "\n=======  tas generique  ========");
+	TasEntiers te2;
+	int entiers[1000];
+	TasEntiers_initialiser(&te2);
+	for(int i = 0; i < 1000; i++)
+		entiers[i] = i*7919 % 1000;
+	TasEntiers_tasser(&te2, entiers, 1000);
+	for(int i = 0; i < 10; i++)
+		TasEntiers_ajouter(&te2, -i);
+	printf("%zu valeurs, sommet %d, ", TasEntiers_taille(&te2), TasEntiers_sommet(&te2));
+	int croissant = 1, avant = TasEntiers_extraire(&te2);
+	while(!TasEntiers_estVide(&te2)){
+		int v = TasEntiers_extraire(&te2);
+		croissant = croissant && v >= avant;
+		avant = v;
+	}
+	printf("%s\n", croissant && avant == 999 ? "trie" : "ECHEC");
+	TasEntiers_finaliser(&te2);
+
+	printf("%s\n", "\n=======  etage de pipeline  ========");
+	TasPipeline tpl = TasPipeline_creer(Tas_comparer_entiers, 16, 5, 10);
+	void* sortie_pipeline[64];
+	for(intptr_t i = 10; i > 0; i--)
+		sortie_pipeline[10-i] = (void*)i;
+	TasPipeline_envoyer_lot(tpl, sortie_pipeline, 10);
+	printf("sature a 10 : %s, ", TasPipeline_sature(tpl) ? "oui" : "non");
+	size_t recus = TasPipeline_recevoir_lot(tpl, sortie_pipeline, 5);
+	printf("%zu recues (%d .. %d), sature a 5 : %s\n", recus, (int)(intptr_t)sortie_pipeline[0],
+		(int)(intptr_t)sortie_pipeline[recus-1], TasPipeline_sature(tpl) ? "oui" : "non");
+	tpl = TasPipeline_detruire(tpl);
+
+	tpl = TasPipeline_creer(Tas_comparer_entiers, 256, 500, 1000);
+	pthread_t producteur;
+	intptr_t somme_pipeline = 0;
+	size_t nb_pipeline = 0;
+	int lots_tries = 1;
+	pthread_create(&producteur, NULL, producteur_pipeline, tpl);
+	while((recus = TasPipeline_recevoir_lot(tpl, sortie_pipeline, 64)) > 0){
+		for(size_t i = 0; i < recus; i++){
+			somme_pipeline += (intptr_t)sortie_pipeline[i];
+			lots_tries = lots_tries && (i == 0 || sortie_pipeline[i-1] <= sortie_pipeline[i]);
+		}
+		nb_pipeline += recus;
+	}
+	pthread_join(producteur, NULL);
+	struct tas_pipeline_stats stats_pipeline;
+	TasPipeline_statistiques(tpl, &stats_pipeline);
+	printf("%zu valeurs, somme %s, lots %s, compteurs %s\n", nb_pipeline,
+		somme_pipeline == 9999*10000/2 ? "exacte" : "ECHEC", lots_tries ? "tries" : "ECHEC",
+		stats_pipeline.envoyees == 10000 && stats_pipeline.sorties == 10000 ? "coherents" : "ECHEC");
+	tpl = TasPipeline_detruire(tpl);
+
+	printf("%s\n", "\n=======  operations groupees  ========");
+	Heap hg = Tas_creer(0);
+	Tas_fixer_comparateur(hg, Tas_comparer_entiers);
+	for(intptr_t i = 0; i < 1000; i++)
+		Tas_ajouter_valeur(hg, (void*)(i % 10));
+	intptr_t somme = 0;
+	Tas_pour_chaque(hg, sommer, &somme);
+	size_t ou = Tas_trouver(hg, (void*)7);
+	printf("somme %ld, 7 en %s, 3 : %zu fois, pairs : %zu\n", (long)somme,
+		(ou != TAS_ABSENT && hg->heap[ou] == (void*)7) ? "place" : "ECHEC",
+		Tas_compter_egaux(hg, (void*)3), Tas_compter_si(hg, est_pair, NULL));
+	printf("3 enleves : %zu, ", Tas_supprimer_egaux(hg, (void*)3));
+	printf("pairs enleves : %zu, ", Tas_supprimer_si(hg, est_pair, NULL));
+	printf("reste %zu, 3 %s, sommet %d\n", Tas_taille(hg),
+		Tas_trouver(hg, (void*)3) == TAS_ABSENT ? "absent" : "ECHEC", (int)(intptr_t)Tas_sommet(hg));
+	hg = Tas_detruire(hg);
+
+	printf("%s\n", "\n=======  vider et recycler  ========");
+	Heap hv = Tas_creer(0);
+	Tas_fixer_comparateur(hv, Tas_comparer_entiers);
+	for(intptr_t i = 1000; i > 0; i--)
+		Tas_ajouter_valeur(hv, (void*)i);
+	void** tableau_avant = hv->heap;
+	size_t capacite_avant = hv->capacite;
+	Tas_vider(hv);
+	for(intptr_t i = 500; i > 0; i--)
+		Tas_ajouter_valeur(hv, (void*)i);
+	printf("apres Tas_vider : taille %zu, sommet %d, tableau %s\n", Tas_taille(hv), (int)(intptr_t)Tas_sommet(hv),
+		hv->heap == tableau_avant && hv->capacite == capacite_avant ? "garde" : "ECHEC");
+	hv = Tas_detruire(hv);
+	// Apres le premier tour, structures et tableaux viennent du cache
+	struct recyclage_stats stats_avant, stats_apres;
+	for(int tour = 0; tour < 101; tour++){
+		if(tour == 1)
+			Recyclage_statistiques(&stats_avant);
+		hv = Tas_creer(0);
+		for(intptr_t i = 0; i < 1000; i++)
+			Tas_ajouter_valeur(hv, (void*)i);
+		hv = Tas_detruire(hv);
+	}
+	Recyclage_statistiques(&stats_apres);
+	printf("100 tas de 1000 valeurs crees et detruits : %s\n",
+		stats_apres.prises - stats_avant.prises == stats_apres.reutilisees - stats_avant.reutilisees
+		&& stats_apres.prises > stats_avant.prises ? "sans malloc" : "ECHEC");
+
+	printf("%s\n", "\n=======  tas grand  ========");
+	// Une page geante contient 262144 cases : 300000 valeurs depassent la
+	// reservation, le tableau est alors deplace une fois
+	Heap hgr = Tas_creerGrand(200000);
+	Tas_fixer_comparateur(hgr, Tas_comparer_entiers);
+	void** tableau_reserve = hgr->heap;
+	for(intptr_t i = 0; i < 262144; i++)
+		Tas_ajouter_valeur(hgr, (void*)((i * 7919) % 262144));
+	printf("262144 valeurs : tableau %s\n", hgr->heap == tableau_reserve ? "jamais deplace" : "ECHEC");
+	for(intptr_t i = 262144; i < 300000; i++)
+		Tas_ajouter_valeur(hgr, (void*)i);
+	int ordre_grand = Tas_taille(hgr) == 300000;
+	for(intptr_t i = 0; i < 300000 && ordre_grand; i++)
+		ordre_grand = Tas_extraire(hgr) == (void*)i;
+	printf("reservation depassee : %s\n", ordre_grand && hgr->reserve >= 300000 ? "300000 valeurs extraites dans l'ordre" : "ECHEC");
+	hgr = Tas_detruire(hgr);
+
+	printf("%s\n", "\n=======  trace  ========");
+	char chemin_trace[] = "/tmp/biblisd_traceXXXXXX";
+	close(mkstemp(chemin_trace));
+	Trace_demarrer(chemin_trace);
+	printf("deuxieme demarrage : %s\n", Trace_demarrer(chemin_trace) < 0 ? "refuse" : "ECHEC");
+	pthread_t fils_trace[2];
+	int objets_trace[2];
+	for(int i = 0; i < 2; i++)
+		pthread_create(&fils_trace[i], NULL, fil_trace, &objets_trace[i]);
+	Trace_evenement(TRACE_TAS_CREER, &objets_trace[0], 0);
+	for(int i = 0; i < 2; i++)
+		pthread_join(fils_trace[i], NULL);
+	Trace_arreter();
+	size_t nb_trace;
+	struct trace_evenement* trace = Trace_lire(chemin_trace, &nb_trace);
+	int dates_croissantes = 1, ordre_garde = 1;
+	uint64_t suivant[2] = {0, 0};
+	for(size_t i = 0; trace != NULL && i < nb_trace; i++){
+		dates_croissantes = dates_croissantes && (i == 0 || TRACE_DATE(&trace[i-1]) <= TRACE_DATE(&trace[i]));
+		if(TRACE_OPERATION(&trace[i]) == TRACE_TAS_AJOUTER){
+			int k = trace[i].objet == (uint64_t)(uintptr_t)&objets_trace[1];
+			ordre_garde = ordre_garde && trace[i].arg == suivant[k]++;
+		}
+	}
+	printf("%zu evenements, dates %s, ordre de chaque fil %s\n", trace ? nb_trace : 0,
+		dates_croissantes ? "croissantes" : "ECHEC", ordre_garde ? "garde" : "ECHEC");
+	free(trace);
+#ifdef BIBLISD_TRACE
+	// Concatenation dans un tas borne : un seul evenement, et le rejeu garde les memes valeurs
+	Trace_demarrer(chemin_trace);
+	Heap tb = Tas_creerBorne(3, Tas_comparer_entiers);
+	Heap ts = Tas_creer(0);
+	Tas_fixer_comparateur(ts, Tas_comparer_entiers);
+	Tas_proposer(tb, (void*)2, NULL);
+	for(intptr_t i = 1; i <= 5; i++)
+		Tas_ajouter_valeur(ts, (void*)i);
+	Tas_concatener(tb, ts);
+	Trace_arreter();
+	trace = Trace_lire(chemin_trace, &nb_trace);
+	Heap rb = Tas_creer(0), rs = Tas_creer(0);
+	Tas_fixer_comparateur(rb, Tas_comparer_entiers);
+	Tas_fixer_comparateur(rs, Tas_comparer_entiers);
+	size_t propositions = 0;
+	for(size_t i = 0; trace != NULL && i < nb_trace; i++){
+		Heap r = trace[i].objet == (uint64_t)(uintptr_t)tb ? rb : rs;
+		switch(TRACE_OPERATION(&trace[i])){
+		case TRACE_TAS_BORNER:
+			Tas_fixer_borne(r, (size_t)trace[i].arg);
+			break;
+		case TRACE_TAS_AJOUTER:
+			Tas_ajouter_valeur(r, (void*)(uintptr_t)trace[i].arg);
+			break;
+		case TRACE_TAS_PROPOSER:
+			propositions++;
+			Tas_proposer(r, (void*)(uintptr_t)trace[i].arg, NULL);
+			break;
+		case TRACE_TAS_CONCATENER:
+			Tas_concatener(r, trace[i].arg == (uint64_t)(uintptr_t)tb ? rb : rs);
+			break;
+		default:
+			break;
+		}
+	}
+	free(trace);
+	int rejeu_identique = Tas_taille(rb) == Tas_taille(tb);
+	printf("concatenation bornee : %zu proposition(s), rejeu", propositions);
+	while(!Tas_estVide(tb)){
+		intptr_t v = (intptr_t)Tas_extraire(tb);
+		rejeu_identique = rejeu_identique && !Tas_estVide(rb) && (intptr_t)Tas_extraire(rb) == v;
+		printf(" %d", (int)v);
+	}
+	printf(" %s\n", rejeu_identique ? "identique" : "DIFFERENT");
+	tb = Tas_detruire(tb);
+	ts = Tas_detruire(ts);
+	rb = Tas_detruire(rb);
+	rs = Tas_detruire(rs);
+#endif
+	unlink(chemin_trace);
+
 	printf("%s\n", "\n=======   supprimer un tas  ========");
 	Tas_afficher(h);
 	h=Tas_detruire(h);
 	Tas_afficher(h);
+	h2=Tas_detruire(h2);
+	h3=Tas_detruire(h3);
 	return 0;
 }
 